@@ -0,0 +1,35 @@
+#include <cstdlib>
+#include <embedded/embedded.hpp>
+#include <exception>
+#include <print>
+
+// Compiles a script during the build, checks the compiled program and runs it twice: once interpreted and once
+// expanded into straight-line code. Both runs print the same text.
+
+static constexpr char source[] = R"(
+// Embedded scripts are written in the same language as `source.bs`.
+println("Hello from an embedded script!");
+print("6 * 7 = ");
+println(6_u64 * 7_u64);
+println((100_u64 - 1_u64) / 3_u64 mod 10_u64);
+)";
+
+static constexpr auto program = embedded::compile<embedded::FixedString{ source }>();
+
+static_assert(program.instructions.size() == 20);
+static_assert(program.instructions.at(7).opcode == embedded::Opcode::Multiply);
+static_assert(program.instructions.at(14).opcode == embedded::Opcode::Divide);
+static_assert(program.instructions.back().opcode == embedded::Opcode::Halt);
+static_assert(program.stack_size == 2);
+static_assert(program.string(0) == "Hello from an embedded script!");
+static_assert(program.string(1) == "6 * 7 = ");
+
+int main() {
+    try {
+        embedded::run(program);
+        embedded::run_inlined<program>();
+    } catch (std::exception const& e) {
+        std::println(stderr, "{}", e.what());
+        return EXIT_FAILURE;
+    }
+}
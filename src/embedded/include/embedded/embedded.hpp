@@ -0,0 +1,415 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <interpreter/error.hpp>
+#include <iterator>
+#include <lexer/tokenizer.hpp>
+#include <parser/error.hpp>
+#include <print>
+#include <string>
+#include <string_view>
+#include <type_checker/errors.hpp>
+#include <type_checker/expressions.hpp>
+#include <type_checker/literals.hpp>
+#include <utility>
+#include <utils/types.hpp>
+#include <vector>
+
+// Compile-time front-end for scripts that are embedded into C++ programs:
+//
+//     static constexpr char source[] = {
+//     #embed "script.bs"
+//         , '\0'
+//     };
+//     static constexpr auto program = embedded::compile<embedded::FixedString{ source }>();
+//     embedded::run_inlined<program>();
+//
+// Lexing, parsing and type checking happen during constant evaluation, so an invalid script fails the build.
+// The supported language is the one of `source.bs`: `print` and `println` of string literals and `U64`
+// arithmetic. Tokens are matched by `lexer::Lexer` and operand types are looked up in the kernel table of
+// `type_checker::BinaryOperator`, so both follow the rules of the interpreter.
+
+namespace embedded {
+
+    template<usize size>
+    struct FixedString final {
+        std::array<char, size> characters{};
+
+        consteval FixedString(char const (&string)[size]) {
+            std::ranges::copy(string, characters.begin());
+        }
+
+        // Without the trailing null terminator (if any).
+        [[nodiscard]] consteval auto view() const -> std::string_view {
+            auto const length = (size > 0 and characters.back() == '\0') ? size - 1 : size;
+            return std::string_view{ characters.data(), length };
+        }
+    };
+
+    // The compiled program runs on a stack of `u64` values. Strings are pushed as indices into
+    // `Program::strings`.
+    enum class Opcode : std::uint8_t {
+        PushU64,      // push(operand)
+        PushString,   // push(operand)
+        Add,          // push(pop(lhs) + pop(rhs))
+        Subtract,     // push(pop(lhs) - pop(rhs))
+        Multiply,     // push(pop(lhs) * pop(rhs))
+        Divide,       // push(pop(lhs) / pop(rhs))
+        Modulo,       // push(pop(lhs) mod pop(rhs))
+        PrintU64,     // print(pop())
+        PrintString,  // print(strings[pop()])
+        PrintNewline, // println()
+        Halt,
+    };
+
+    struct Instruction final {
+        Opcode opcode;
+        std::uint64_t operand;
+    };
+
+    struct StringSlice final {
+        usize offset;
+        usize length;
+    };
+
+    // A structural type, so that programs can be used as template arguments (see `run_inlined()`). All sizes are
+    // at least one.
+    template<usize num_instructions, usize num_strings, usize num_characters>
+    struct Program final {
+        std::array<Instruction, num_instructions> instructions;
+        std::array<StringSlice, num_strings> strings;
+        std::array<char, num_characters> characters;
+        usize stack_size;
+
+        [[nodiscard]] constexpr auto string(std::uint64_t const index) const -> std::string_view {
+            auto const [offset, length] = strings[index];
+            return std::string_view{ characters.data() + offset, length };
+        }
+    };
+
+    namespace detail {
+        using lexer::Token;
+        using type_checker::BuiltinDataType;
+
+        // The tokens are matched by the same generated patterns as in `lexer::tokenize()`.
+        [[nodiscard]] consteval auto tokenize(std::string_view const source) -> std::vector<Token> {
+            auto tokens = lexer::Lexer{ "<embedded>", source }.tokenize();
+            if (not tokens.has_value()) {
+                throw std::move(tokens).error();
+            }
+            return std::move(tokens).value();
+        }
+
+        struct CompiledScript final {
+            std::vector<Instruction> instructions;
+            std::vector<StringSlice> strings;
+            std::string characters;
+            usize stack_size{ 0 };
+        };
+
+        // Recursive descent parser that type checks while it emits stack code. Precedence climbing follows
+        // `parser::Precedence`: `+` and `-` bind weaker than `*`, `/` and `mod`. Errors are reported with the
+        // exception types of `parser::parse()` and `type_checker::check_types()`.
+        class Compiler final {
+        private:
+            std::vector<Token> m_tokens;
+            usize m_index{ 0 };
+            usize m_stack_depth{ 0 };
+            CompiledScript m_script;
+
+        public:
+            [[nodiscard]] consteval explicit Compiler(std::string_view const source) : m_tokens{ tokenize(source) } { }
+
+            [[nodiscard]] consteval auto compile() && -> CompiledScript {
+                while (current().type() != lexer::TokenType::EndOfFile) {
+                    statement();
+                }
+                emit(Opcode::Halt);
+                m_script.stack_size = std::max(m_script.stack_size, 1uz);
+                return std::move(m_script);
+            }
+
+        private:
+            [[nodiscard]] consteval auto current() const -> Token const& {
+                return m_tokens.at(m_index);
+            }
+
+            consteval auto expect(lexer::TokenType const type, char const* const message) -> Token {
+                if (current().type() != type) {
+                    throw parser::ParserError{ message };
+                }
+                return m_tokens.at(m_index++);
+            }
+
+            consteval auto emit(Opcode const opcode, std::uint64_t const operand = 0) -> void {
+                m_script.instructions.push_back(Instruction{ opcode, operand });
+                switch (opcode) {
+                    case Opcode::PushU64:
+                    case Opcode::PushString:
+                        ++m_stack_depth;
+                        m_script.stack_size = std::max(m_script.stack_size, m_stack_depth);
+                        break;
+                    case Opcode::PrintU64:
+                    case Opcode::PrintString:
+                    case Opcode::Add:
+                    case Opcode::Subtract:
+                    case Opcode::Multiply:
+                    case Opcode::Divide:
+                    case Opcode::Modulo:
+                        --m_stack_depth;
+                        break;
+                    case Opcode::PrintNewline:
+                    case Opcode::Halt:
+                        break;
+                }
+            }
+
+            consteval auto statement() -> void {
+                auto const is_println = (current().type() == lexer::TokenType::Println);
+                if (not is_println and current().type() != lexer::TokenType::Print) {
+                    throw parser::ParserError{ "Expected 'print' or 'println'." };
+                }
+                ++m_index;
+                expect(lexer::TokenType::LeftParenthesis, "Expected '('.");
+                // Same rules as `type_checker::check_printable()`.
+                switch (expression()) {
+                    case BuiltinDataType::String:
+                        emit(Opcode::PrintString);
+                        break;
+                    case BuiltinDataType::U64:
+                        emit(Opcode::PrintU64);
+                        break;
+                }
+                expect(lexer::TokenType::RightParenthesis, "Expected ')'.");
+                expect(lexer::TokenType::Semicolon, "Expected ';'.");
+                if (is_println) {
+                    emit(Opcode::PrintNewline);
+                }
+            }
+
+            consteval auto expression() -> BuiltinDataType {
+                auto lhs_type = term();
+                while (current().type() == lexer::TokenType::Plus or current().type() == lexer::TokenType::Minus) {
+                    auto const operator_token = m_tokens.at(m_index++);
+                    lhs_type = binary_operator(operator_token, lhs_type, term());
+                }
+                return lhs_type;
+            }
+
+            consteval auto term() -> BuiltinDataType {
+                auto lhs_type = primary();
+                while (current().type() == lexer::TokenType::Asterisk
+                       or current().type() == lexer::TokenType::ForwardSlash
+                       or current().type() == lexer::TokenType::Mod) {
+                    auto const operator_token = m_tokens.at(m_index++);
+                    lhs_type = binary_operator(operator_token, lhs_type, primary());
+                }
+                return lhs_type;
+            }
+
+            consteval auto primary() -> BuiltinDataType {
+                auto const token = current();
+                auto const lexeme = token.source_location().lexeme();
+                switch (token.type()) {
+                    case lexer::TokenType::UnsignedIntegerLiteral:
+                        ++m_index;
+                        emit(Opcode::PushU64, type_checker::decode_unsigned_integer_literal(lexeme));
+                        return BuiltinDataType::U64;
+                    case lexer::TokenType::StringLiteral: {
+                        ++m_index;
+                        auto const decoded = type_checker::decode_string_literal(lexeme);
+                        m_script.strings.push_back(StringSlice{ m_script.characters.length(), decoded.length() });
+                        m_script.characters += decoded;
+                        emit(Opcode::PushString, m_script.strings.size() - 1);
+                        return BuiltinDataType::String;
+                    }
+                    case lexer::TokenType::LeftParenthesis: {
+                        ++m_index;
+                        auto const data_type = expression();
+                        expect(lexer::TokenType::RightParenthesis, "Expected ')'.");
+                        return data_type;
+                    }
+                    default:
+                        throw parser::ParserError{ "Expected expression." };
+                }
+            }
+
+            // Looks up the resulting data type in the kernel table of `type_checker::BinaryOperator`.
+            consteval auto binary_operator(
+                    Token const& operator_token,
+                    BuiltinDataType const lhs_type,
+                    BuiltinDataType const rhs_type
+            ) -> BuiltinDataType {
+                using type_checker::BinaryOperator;
+                auto const operator_index = static_cast<usize>(std::distance(
+                        BinaryOperator::operator_token_types.begin(),
+                        std::ranges::find(BinaryOperator::operator_token_types, operator_token.type())
+                ));
+                auto const result_type = BinaryOperator::get_resulting_data_type(
+                        BinaryOperator::get_kernel(operator_index, lhs_type, rhs_type)
+                );
+                if (not result_type.has_value()) {
+                    throw type_checker::InvalidTypeError{ "Invalid operand types for binary operator." };
+                }
+                emit(opcode_of(operator_token.type()));
+                return result_type.value();
+            }
+
+            [[nodiscard]] static consteval auto opcode_of(lexer::TokenType const type) -> Opcode {
+                switch (type) {
+                    case lexer::TokenType::Plus:
+                        return Opcode::Add;
+                    case lexer::TokenType::Minus:
+                        return Opcode::Subtract;
+                    case lexer::TokenType::Asterisk:
+                        return Opcode::Multiply;
+                    case lexer::TokenType::ForwardSlash:
+                        return Opcode::Divide;
+                    case lexer::TokenType::Mod:
+                        return Opcode::Modulo;
+                    default:
+                        throw parser::ParserError{ "Unsupported binary operator." };
+                }
+            }
+        };
+
+        [[nodiscard]] consteval auto compile_script(std::string_view const source) -> CompiledScript {
+            return Compiler{ source }.compile();
+        }
+
+        template<typename T, usize size>
+        consteval auto copy_into(std::array<T, size>& destination, auto const& source) -> void {
+            std::ranges::copy(source, destination.begin());
+        }
+
+        // Divisions by zero are not checked at compile time, so the output before them is still written.
+        [[noreturn]] inline auto throw_division_by_zero() -> void {
+            throw interpreter::InterpreterError{ "Division by zero." };
+        }
+    } // namespace detail
+
+    // Compiles the script into a program. Must be used in a constant expression.
+    template<FixedString source>
+    [[nodiscard]] consteval auto compile() {
+        static constexpr auto sizes = [] {
+            auto const script = detail::compile_script(source.view());
+            return std::array{
+                script.instructions.size(),
+                std::max(script.strings.size(), 1uz),
+                std::max(script.characters.size(), 1uz),
+            };
+        }();
+        auto const script = detail::compile_script(source.view());
+        auto program = Program<sizes[0], sizes[1], sizes[2]>{};
+        detail::copy_into(program.instructions, script.instructions);
+        detail::copy_into(program.strings, script.strings);
+        detail::copy_into(program.characters, script.characters);
+        program.stack_size = script.stack_size;
+        return program;
+    }
+
+    // Runs a compiled program by interpreting its instructions.
+    template<usize num_instructions, usize num_strings, usize num_characters>
+    auto run(Program<num_instructions, num_strings, num_characters> const& program) -> void {
+        auto stack = std::vector<std::uint64_t>{};
+        stack.reserve(program.stack_size);
+        auto const pop = [&stack] {
+            auto const value = stack.back();
+            stack.pop_back();
+            return value;
+        };
+        for (auto const& [opcode, operand] : program.instructions) {
+            switch (opcode) {
+                case Opcode::PushU64:
+                case Opcode::PushString:
+                    stack.push_back(operand);
+                    break;
+                case Opcode::Add: {
+                    auto const rhs = pop();
+                    stack.back() += rhs;
+                    break;
+                }
+                case Opcode::Subtract: {
+                    auto const rhs = pop();
+                    stack.back() -= rhs;
+                    break;
+                }
+                case Opcode::Multiply: {
+                    auto const rhs = pop();
+                    stack.back() *= rhs;
+                    break;
+                }
+                case Opcode::Divide: {
+                    auto const rhs = pop();
+                    if (rhs == 0) {
+                        detail::throw_division_by_zero();
+                    }
+                    stack.back() /= rhs;
+                    break;
+                }
+                case Opcode::Modulo: {
+                    auto const rhs = pop();
+                    if (rhs == 0) {
+                        detail::throw_division_by_zero();
+                    }
+                    stack.back() %= rhs;
+                    break;
+                }
+                case Opcode::PrintU64:
+                    std::print("{}", pop());
+                    break;
+                case Opcode::PrintString:
+                    std::print("{}", program.string(pop()));
+                    break;
+                case Opcode::PrintNewline:
+                    std::println();
+                    break;
+                case Opcode::Halt:
+                    return;
+            }
+        }
+    }
+
+    // Runs a compiled program through a function that is specialized for it: every instruction is expanded
+    // into straight-line code, so the optimizer sees all operands as constants.
+    template<auto program>
+    auto run_inlined() -> void {
+        auto stack = std::array<std::uint64_t, program.stack_size>{};
+        auto top = 0uz;
+        template for (constexpr auto instruction : program.instructions) {
+            if constexpr (instruction.opcode == Opcode::PushU64 or instruction.opcode == Opcode::PushString) {
+                stack[top++] = instruction.operand;
+            } else if constexpr (instruction.opcode == Opcode::Add) {
+                --top;
+                stack[top - 1] += stack[top];
+            } else if constexpr (instruction.opcode == Opcode::Subtract) {
+                --top;
+                stack[top - 1] -= stack[top];
+            } else if constexpr (instruction.opcode == Opcode::Multiply) {
+                --top;
+                stack[top - 1] *= stack[top];
+            } else if constexpr (instruction.opcode == Opcode::Divide) {
+                --top;
+                if (stack[top] == 0) {
+                    detail::throw_division_by_zero();
+                }
+                stack[top - 1] /= stack[top];
+            } else if constexpr (instruction.opcode == Opcode::Modulo) {
+                --top;
+                if (stack[top] == 0) {
+                    detail::throw_division_by_zero();
+                }
+                stack[top - 1] %= stack[top];
+            } else if constexpr (instruction.opcode == Opcode::PrintU64) {
+                std::print("{}", stack[--top]);
+            } else if constexpr (instruction.opcode == Opcode::PrintString) {
+                std::print("{}", program.string(stack[--top]));
+            } else if constexpr (instruction.opcode == Opcode::PrintNewline) {
+                std::println();
+            }
+        }
+    }
+
+} // namespace embedded
@@ -0,0 +1,86 @@
+#include <backseat/backseat.hpp>
+#include <backseat/interpreter.hpp>
+#include <exception>
+#include <lexer/lexer.hpp>
+#include <parser/parser.hpp>
+#include <type_checker/type_checker.hpp>
+#include <utility>
+#include <vector>
+
+namespace backseat {
+
+    namespace {
+        // Typed statements don't refer to the source, so it is not needed after compilation.
+        struct TypedProgram final {
+            std::vector<std::unique_ptr<type_checker::Statement>> statements;
+        };
+
+        [[nodiscard]] auto make_program(
+                std::vector<std::unique_ptr<type_checker::Statement>> statements,
+                CompileOptions const& options
+        ) -> Program {
+            auto const typed_program = std::make_shared<TypedProgram>(std::move(statements));
+            auto shared_statements = std::vector<std::shared_ptr<type_checker::Statement const>>{};
+            shared_statements.reserve(typed_program->statements.size());
+            for (auto const& statement : typed_program->statements) {
+                // The aliasing constructor makes every statement keep the whole program alive.
+                shared_statements.emplace_back(typed_program, statement.get());
+            }
+            return Program{ interpreter::CompiledProgram::compile(
+                    std::move(shared_statements),
+                    options.engine,
+                    options.optimization_level
+            ) };
+        }
+    } // namespace
+
+    [[nodiscard]] auto compile(std::string_view const source, CompileOptions const& options) -> Program {
+        auto const tokens = lexer::tokenize(options.filename, source);
+        auto statements = type_checker::check_types(parser::parse(tokens));
+        return make_program(std::move(statements), options);
+    }
+
+    [[nodiscard]] auto try_compile(
+            std::string_view const source,
+            utils::Diagnostics& diagnostics,
+            CompileOptions const& options
+    ) -> std::expected<Program, utils::DiagnosticKind> {
+        auto const tokens = lexer::try_tokenize(options.filename, source, diagnostics);
+        if (not tokens.has_value()) {
+            return std::unexpected{ tokens.error() };
+        }
+        auto parse_tree = parser::try_parse(tokens.value(), diagnostics);
+        if (not parse_tree.has_value()) {
+            return std::unexpected{ parse_tree.error() };
+        }
+        auto statements = type_checker::try_check_types(std::move(parse_tree).value(), diagnostics);
+        if (not statements.has_value()) {
+            return std::unexpected{ statements.error() };
+        }
+        try {
+            return make_program(std::move(statements).value(), options);
+        } catch (std::exception const& error) {
+            // Preparing the engine can fail as well, e.g. with `std::bad_alloc` or when the code of the JIT cannot
+            // be mapped. Callers rely on `try_compile()` not throwing.
+            diagnostics.report(utils::DiagnosticKind::RuntimeError, error.what());
+        } catch (...) {
+            diagnostics.report(utils::DiagnosticKind::RuntimeError, "Unknown error.");
+        }
+        return std::unexpected{ utils::DiagnosticKind::RuntimeError };
+    }
+
+    auto run(Program const& program, interpreter::OutputSink& output) -> void {
+        auto interpreter = interpreter::Interpreter{ program.compiled() };
+        interpreter.run(output);
+    }
+
+    [[nodiscard]] auto try_run(
+            Program const& program,
+            interpreter::OutputSink& output,
+            utils::Diagnostics& diagnostics
+    ) -> std::expected<void, utils::DiagnosticKind> {
+        auto interpreter = interpreter::Interpreter{ program.compiled() };
+        return interpreter.try_run(output, diagnostics);
+    }
+
+} // namespace backseat
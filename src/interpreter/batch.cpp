@@ -0,0 +1,54 @@
+#include <backseat/batch.hpp>
+#include <exception>
+#include <tuple>
+
+namespace backseat {
+
+    [[nodiscard]] auto BatchExecutor::run(std::span<BatchScript const> const scripts) -> std::vector<BatchResult> {
+        return execute(
+                scripts.size(),
+                [&](usize const index, interpreter::OutputSink& output, utils::Diagnostics& diagnostics) {
+                    auto const& [filename, source] = scripts[index];
+                    auto options = m_options;
+                    options.filename = filename;
+                    auto const program = try_compile(source, diagnostics, options);
+                    if (program.has_value()) {
+                        std::ignore = try_run(program.value(), output, diagnostics);
+                    }
+                }
+        );
+    }
+
+    [[nodiscard]] auto BatchExecutor::run(std::span<Program const> const programs) -> std::vector<BatchResult> {
+        return execute(
+                programs.size(),
+                [&](usize const index, interpreter::OutputSink& output, utils::Diagnostics& diagnostics) {
+                    std::ignore = try_run(programs[index], output, diagnostics);
+                }
+        );
+    }
+
+    [[nodiscard]] auto BatchExecutor::execute(
+            usize const count,
+            std::function<void(usize, interpreter::OutputSink&, utils::Diagnostics&)> const& function
+    ) -> std::vector<BatchResult> {
+        auto results = std::vector<BatchResult>(count);
+        m_pool.for_each_index(count, [&](usize const index, usize const worker_index) {
+            auto& worker = m_workers.at(worker_index);
+            auto& result = results.at(index);
+            result.output.reserve(worker.output_capacity);
+            {
+                auto output = interpreter::OutputSink::to_memory(result.output);
+                try {
+                    function(index, output, result.diagnostics);
+                } catch (std::exception const& e) {
+                    // A failing script must not take the rest of the batch down with it.
+                    result.diagnostics.report(utils::DiagnosticKind::RuntimeError, e.what());
+                }
+            }
+            worker.output_capacity = result.output.size();
+        });
+        return results;
+    }
+
+} // namespace backseat
@@ -0,0 +1,170 @@
+#include <backseat/batch.hpp>
+#include <backseat/interpreter.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <format>
+#include <iterator>
+#include <lexer/lexer.hpp>
+#include <memory>
+#include <parser/parser.hpp>
+#include <print>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_checker/type_checker.hpp>
+#include <utils/thread_pool.hpp>
+#include <vector>
+
+// Compares the execution engines on a generated, arithmetic-heavy script, then measures how running a batch of
+// small scripts scales with the number of workers. The output of the scripts is discarded, the timings are printed
+// to stderr.
+
+[[nodiscard]] static auto generate_script(usize const num_statements) -> std::string {
+    auto script = std::string{};
+    for (auto i = 0uz; i < num_statements; ++i) {
+        script += std::format(
+                "println(({0}_u64 * 31_u64 + 7_u64) * ({0}_u64 mod 13_u64 + 1_u64) / 3_u64 - {0}_u64 + 42_u64);\n",
+                i
+        );
+        if (i % 16 == 0) {
+            script += "print(\"checkpoint \");\n";
+        }
+    }
+    return script;
+}
+
+[[nodiscard]] static auto measure(
+        std::vector<std::shared_ptr<type_checker::Statement const>> const& program,
+        interpreter::Engine const engine,
+        utils::WorkStealingPool* const pool,
+        usize const num_repetitions
+) -> std::chrono::nanoseconds {
+    // Compilation is part of the measurement since every engine but the tree-walker has to compile first.
+    auto const start = std::chrono::steady_clock::now();
+    for (auto i = 0uz; i < num_repetitions; ++i) {
+        auto interpreter = interpreter::Interpreter{ program, engine };
+        if (pool != nullptr) {
+            interpreter.run(*pool);
+        } else {
+            interpreter.run();
+        }
+    }
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+}
+
+// Compiling is part of the measurement, just like for a batch job.
+[[nodiscard]] static auto measure_batch(
+        std::vector<backseat::BatchScript> const& scripts,
+        usize const num_workers,
+        usize const num_repetitions
+) -> std::chrono::nanoseconds {
+    auto executor = backseat::BatchExecutor{ backseat::CompileOptions{}, num_workers };
+    auto const start = std::chrono::steady_clock::now();
+    for (auto i = 0uz; i < num_repetitions; ++i) {
+        auto const results = executor.run(scripts);
+        if (not std::ranges::all_of(results, &backseat::BatchResult::succeeded)) {
+            throw std::runtime_error{ "A script of the batch has failed." };
+        }
+    }
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+}
+
+int main() {
+    try {
+        static constexpr auto num_statements = 10'000uz;
+        static constexpr auto num_repetitions = 20uz;
+
+        auto const source = generate_script(num_statements);
+        auto const tokens = lexer::tokenize("benchmark.bs", source);
+        auto typed_program = type_checker::check_types(parser::parse(tokens));
+        auto const program = std::vector<std::shared_ptr<type_checker::Statement const>>(
+                std::make_move_iterator(typed_program.begin()),
+                std::make_move_iterator(typed_program.end())
+        );
+
+        if (std::freopen("/dev/null", "w", stdout) == nullptr) {
+            std::println(stderr, "Unable to redirect stdout.");
+            return EXIT_FAILURE;
+        }
+
+        struct Candidate final {
+            std::string_view name;
+            interpreter::Engine engine;
+            bool is_parallel;
+        };
+        static constexpr auto candidates = std::array{
+            Candidate{ "tree", interpreter::Engine::Tree, false },
+            Candidate{ "tree-parallel", interpreter::Engine::Tree, true },
+            Candidate{ "bytecode", interpreter::Engine::Bytecode, false },
+            Candidate{ "jit", interpreter::Engine::Jit, false },
+            Candidate{ "closures", interpreter::Engine::Closures, false },
+            Candidate{ "ir", interpreter::Engine::Ir, false },
+        };
+
+        // Every engine is compared against both interpreting engines, the tree walker and the bytecode VM.
+        auto pool = utils::WorkStealingPool{};
+        auto durations = std::vector<std::chrono::nanoseconds>{};
+        durations.reserve(candidates.size());
+        for (auto const& [name, engine, is_parallel] : candidates) {
+            durations.push_back(
+                    measure(program, engine, is_parallel ? std::addressof(pool) : nullptr, num_repetitions)
+            );
+        }
+        auto const duration_of = [&](std::string_view const name) {
+            auto const it = std::ranges::find(candidates, name, &Candidate::name);
+            return durations.at(static_cast<usize>(std::distance(candidates.begin(), it)));
+        };
+        auto const tree_duration = duration_of("tree");
+        auto const bytecode_duration = duration_of("bytecode");
+        for (auto i = 0uz; i < candidates.size(); ++i) {
+            auto const duration = static_cast<double>(durations.at(i).count());
+            std::println(
+                    stderr,
+                    "{:>14}: {:>10.3f} ms per run ({:.2f}x vs. tree, {:.2f}x vs. bytecode)",
+                    candidates.at(i).name,
+                    duration / 1e6 / static_cast<double>(num_repetitions),
+                    static_cast<double>(tree_duration.count()) / duration,
+                    static_cast<double>(bytecode_duration.count()) / duration
+            );
+        }
+
+        // Many small, independent scripts, run with 1, 2, 4, ... workers up to the number of cores.
+        static constexpr auto num_batch_scripts = 2'000uz;
+        static constexpr auto num_statements_per_batch_script = 50uz;
+        static constexpr auto num_batch_repetitions = 5uz;
+        auto const batch_source = generate_script(num_statements_per_batch_script);
+        auto const batch_scripts = std::vector(num_batch_scripts, backseat::BatchScript{ "batch.bs", batch_source });
+        auto const max_num_workers = std::max(usize{ std::thread::hardware_concurrency() }, 1uz);
+        auto worker_counts = std::vector<usize>{};
+        for (auto num_workers = 1uz; num_workers < max_num_workers; num_workers *= 2) {
+            worker_counts.push_back(num_workers);
+        }
+        worker_counts.push_back(max_num_workers);
+
+        auto single_worker_duration = std::chrono::nanoseconds{};
+        for (auto const num_workers : worker_counts) {
+            auto const duration = measure_batch(batch_scripts, num_workers, num_batch_repetitions);
+            if (num_workers == 1) {
+                single_worker_duration = duration;
+            }
+            auto const speedup = static_cast<double>(single_worker_duration.count())
+                                 / static_cast<double>(duration.count());
+            std::println(
+                    stderr,
+                    "batch, {:>3} workers: {:>10.3f} ms per batch ({:.2f}x vs. 1 worker, {:.0f}% efficiency)",
+                    num_workers,
+                    static_cast<double>(duration.count()) / 1e6 / static_cast<double>(num_batch_repetitions),
+                    speedup,
+                    speedup / static_cast<double>(num_workers) * 100.0
+            );
+        }
+    } catch (std::exception const& e) {
+        std::println(stderr, "{}", e.what());
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,213 @@
+#include "server_protocol.hpp"
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fcntl.h>
+#include <filesystem>
+#include <optional>
+#include <poll.h>
+#include <print>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unistd.h>
+#include <utils/files.hpp>
+#include <utils/types.hpp>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    struct Request final {
+        interpreter::ServerRequestHeader header;
+        std::string name;
+        std::string source;
+    };
+
+    [[nodiscard]] auto make_request(std::string_view const path) -> Request {
+        auto request = Request{};
+        if (path == "-") {
+            request.header.kind = interpreter::ServerRequestKind::RunSource;
+            request.name = "<stdin>";
+            request.source = utils::read_stdin();
+        } else {
+            // The server may run in a different working directory.
+            request.header.kind = interpreter::ServerRequestKind::RunFile;
+            request.name = std::filesystem::absolute(path).string();
+        }
+        if (request.name.size() > interpreter::max_request_name_length) {
+            throw std::invalid_argument{ "Path is too long." };
+        }
+        if (request.source.size() > interpreter::max_request_source_length) {
+            throw std::invalid_argument{ "Script is too large." };
+        }
+        request.header.name_length = static_cast<std::uint32_t>(request.name.size());
+        request.header.source_length = static_cast<std::uint32_t>(request.source.size());
+        return request;
+    }
+
+    // The server writes the output of the script directly to `output`.
+    auto send_request(int const socket, Request const& request, int const output) -> void {
+        interpreter::send_with_file_descriptor(socket, interpreter::as_bytes(request.header), output);
+        interpreter::send_all(socket, request.name);
+        interpreter::send_all(socket, request.source);
+    }
+
+    // Returns the error message of the server if the script has failed.
+    [[nodiscard]] auto receive_response(int const socket) -> std::optional<std::string> {
+        auto response = interpreter::ServerResponseHeader{};
+        if (not interpreter::receive_all(socket, interpreter::as_writable_bytes(response))) {
+            throw std::runtime_error{ "Connection closed unexpectedly." };
+        }
+        if (response.success) {
+            return std::nullopt;
+        }
+        auto message = std::string(response.message_length, '\0');
+        if (not interpreter::receive_all(socket, message)) {
+            throw std::runtime_error{ "Connection closed unexpectedly." };
+        }
+        return message;
+    }
+
+    // Copies the output of the script from the (non-blocking) `pipe` to stdout until the response arrives on
+    // `socket`. Returns the time at which the first byte of output has arrived.
+    [[nodiscard]] auto relay_output(int const socket, int const pipe) -> std::optional<Clock::time_point> {
+        auto first_byte = std::optional<Clock::time_point>{};
+        auto buffer = std::array<char, 64 * 1024>{};
+        auto const relay_chunk = [&] {
+            auto const num_bytes = ::read(pipe, buffer.data(), buffer.size());
+            if (num_bytes <= 0) {
+                if (num_bytes < 0 and errno != EAGAIN and errno != EINTR) {
+                    throw std::runtime_error{ "Unable to read output." };
+                }
+                return num_bytes < 0 and errno == EINTR;
+            }
+            if (not first_byte.has_value()) {
+                first_byte = Clock::now();
+            }
+            std::fwrite(buffer.data(), 1, static_cast<usize>(num_bytes), stdout);
+            return true;
+        };
+
+        while (true) {
+            auto descriptors = std::array{ pollfd{ pipe, POLLIN, 0 }, pollfd{ socket, POLLIN, 0 } };
+            if (::poll(descriptors.data(), descriptors.size(), -1) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error{ "Unable to wait for output." };
+            }
+            if ((descriptors[0].revents & POLLIN) != 0) {
+                std::ignore = relay_chunk();
+                continue;
+            }
+            if (descriptors[1].revents != 0) {
+                break;
+            }
+        }
+        // The server flushes the output before it responds, so the rest of it is already in the pipe.
+        while (relay_chunk()) { }
+        std::fflush(stdout);
+        return first_byte;
+    }
+
+    [[nodiscard]] auto to_microseconds(Clock::duration const duration) -> double {
+        return std::chrono::duration<double, std::micro>{ duration }.count();
+    }
+} // namespace
+
+// Usage: interpreter_client [--time] <socket> [file...]
+//
+// Runs the scripts on a compile server that has been started with `interpreter --serve=<socket>` or
+// `interpreter --zygote=<socket>`. `-` sends the script from stdin, and `source.bs` is run if no file is given.
+// Errors are reported like the interpreter does.
+//
+// With `--time`, the output is relayed through a pipe instead of being written to stdout by the server directly.
+// This way the time from sending a request to the first byte of output can be measured, which is reported on
+// stderr for every script.
+int main(int const argc, char const* const* const argv) {
+    try {
+        auto const arguments = std::span{ argv, static_cast<usize>(argc) };
+        auto measure_time = false;
+        auto positional_arguments = std::vector<std::string_view>{};
+        for (auto const argument : arguments.subspan(1)) {
+            if (std::string_view{ argument } == "--time") {
+                measure_time = true;
+            } else {
+                positional_arguments.emplace_back(argument);
+            }
+        }
+        if (positional_arguments.empty()) {
+            std::println(stderr, "Usage: interpreter_client [--time] <socket> [file...]");
+            return EXIT_FAILURE;
+        }
+        auto paths = std::vector<std::string_view>{ positional_arguments.begin() + 1, positional_arguments.end() };
+        if (paths.empty()) {
+            paths.emplace_back("source.bs");
+        }
+
+        // The server only waits for a started request for a short time, so all input (including stdin) is read
+        // before connecting.
+        auto requests = std::vector<Request>{};
+        requests.reserve(paths.size());
+        for (auto const path : paths) {
+            requests.push_back(make_request(path));
+        }
+
+        auto const socket = interpreter::connect_to_server(positional_arguments.front());
+        auto output_pipe = std::array<int, 2>{ -1, -1 };
+        if (measure_time and ::pipe2(output_pipe.data(), O_CLOEXEC) != 0) {
+            throw std::runtime_error{ "Unable to create pipe." };
+        }
+        auto const pipe_read_end = interpreter::FileDescriptor{ output_pipe[0] };
+        auto const pipe_write_end = interpreter::FileDescriptor{ output_pipe[1] };
+        // Only our end is non-blocking, the server must be able to block when the pipe is full.
+        if (measure_time and ::fcntl(pipe_read_end.get(), F_SETFL, O_NONBLOCK) != 0) {
+            throw std::runtime_error{ "Unable to create pipe." };
+        }
+
+        auto num_failures = 0uz;
+        for (auto i = 0uz; i < paths.size(); ++i) {
+            auto const path = paths.at(i);
+            auto const& request = requests.at(i);
+            auto error = std::optional<std::string>{};
+            if (measure_time) {
+                auto const start = Clock::now();
+                send_request(socket.get(), request, pipe_write_end.get());
+                auto const first_byte = relay_output(socket.get(), pipe_read_end.get());
+                error = receive_response(socket.get());
+                auto const end = Clock::now();
+                if (first_byte.has_value()) {
+                    std::println(
+                            stderr,
+                            "{}: first byte after {:.1f} us, done after {:.1f} us",
+                            path,
+                            to_microseconds(*first_byte - start),
+                            to_microseconds(end - start)
+                    );
+                } else {
+                    std::println(stderr, "{}: no output, done after {:.1f} us", path, to_microseconds(end - start));
+                }
+            } else {
+                send_request(socket.get(), request, STDOUT_FILENO);
+                error = receive_response(socket.get());
+            }
+            if (error.has_value()) {
+                std::println("{}", *error);
+                // The server writes to our stdout directly, so later output must not overtake this message.
+                std::fflush(stdout);
+                ++num_failures;
+            }
+        }
+        return num_failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    } catch (std::exception const& e) {
+        std::println("{}", e.what());
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,364 @@
+#pragma once
+
+#include "server_protocol.hpp"
+#include <algorithm>
+#include <backseat/interpreter.hpp>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fcntl.h>
+#include <filesystem>
+#include <format>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <poll.h>
+#include <print>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <type_checker/compilation_cache.hpp>
+#include <unistd.h>
+#include <unordered_map>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include <utils/files.hpp>
+
+namespace interpreter {
+
+    // Makes a file descriptor non-blocking for the lifetime of the guard. The flag belongs to the open file
+    // description, which is shared with the process that has passed the descriptor, so the previous flags are
+    // restored afterwards.
+    class NonBlockingGuard final {
+    private:
+        int m_file_descriptor;
+        int m_flags;
+
+    public:
+        [[nodiscard]] explicit NonBlockingGuard(int const file_descriptor)
+            : m_file_descriptor{ file_descriptor },
+              m_flags{ ::fcntl(file_descriptor, F_GETFL) } {
+            if (m_flags < 0 or ::fcntl(m_file_descriptor, F_SETFL, m_flags | O_NONBLOCK) != 0) {
+                throw std::runtime_error{ "Unable to prepare output." };
+            }
+        }
+
+        NonBlockingGuard(NonBlockingGuard const& other) = delete;
+        NonBlockingGuard(NonBlockingGuard&& other) noexcept = delete;
+        NonBlockingGuard& operator=(NonBlockingGuard const& other) = delete;
+        NonBlockingGuard& operator=(NonBlockingGuard&& other) noexcept = delete;
+
+        ~NonBlockingGuard() {
+            ::fcntl(m_file_descriptor, F_SETFL, m_flags);
+        }
+    };
+
+    enum class ServerIsolation {
+        InProcess,     // Scripts run inside the server process.
+        ForkPerScript, // Every script runs in a child process that is forked from the server (a zygote).
+    };
+
+    // Listens on a Unix domain socket and runs the scripts that clients send to it (see `server_protocol.hpp`),
+    // so that starting the interpreter is only paid for once. Compiled programs are cached by name and contents:
+    // repeated requests for an unchanged script skip lexing, parsing, type checking and compiling for the engine.
+    //
+    // Requests are handled one at a time, but up to `max_num_connections` clients can keep a connection open
+    // between requests. The output of a script is written to the stdout of the client directly. A client that has
+    // started a request and doesn't complete it within `client_timeout` is disconnected, and a script whose client
+    // doesn't accept more output for that long fails, so a stalled client can't block the others for longer than
+    // that. Requests with names or sources beyond the limits of `server_protocol.hpp` are rejected before anything
+    // is allocated for them.
+    //
+    // With `ServerIsolation::ForkPerScript`, the server compiles the script and forks a child that runs it. The
+    // child starts with everything that the server has initialized (the lexer and parser tables, the global
+    // tables of the type checker, the caches of the engines and all compiled programs) as copy-on-write memory,
+    // and a crashing script only takes down its own process.
+    class CompileServer final {
+    private:
+        // The cache is dropped as a whole when it is full.
+        static constexpr auto max_num_cached_programs = 256uz;
+        static constexpr auto client_timeout = std::chrono::seconds{ 5 };
+        // Further clients have to wait until a connection is closed.
+        static constexpr auto max_num_connections = 256uz;
+        // Exit status of a script process that has sent part of its response and failed to send the rest.
+        static constexpr auto partial_response_status = 2;
+        // Touches every statement and operator, so that all lazily initialized state exists before the first
+        // request (and, with `ServerIsolation::ForkPerScript`, before the first fork).
+        static constexpr auto warm_up_script = std::string_view{
+            "print(\"\"); println(\"\\n\"); println(1_u64 + 2_u64 * 3_u64 - 4_u64 / 5_u64 mod 6_u64);"
+        };
+
+        std::string m_socket_path;
+        FileDescriptor m_socket;
+        Engine m_engine;
+        ir::OptimizationLevel m_optimization_level;
+        ServerIsolation m_isolation;
+        // Keyed by the name of the script, followed by a null character and its contents.
+        std::unordered_map<std::string, std::unique_ptr<Interpreter>> m_programs;
+
+    public:
+        // An existing file at `socket_path` is replaced.
+        [[nodiscard]] explicit CompileServer(
+                std::string socket_path,
+                Engine const engine = Engine::Tree,
+                ir::OptimizationLevel const optimization_level = ir::OptimizationLevel::O2,
+                ServerIsolation const isolation = ServerIsolation::InProcess
+        )
+            : m_socket_path{ std::move(socket_path) },
+              m_socket{ ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0) },
+              m_engine{ engine },
+              m_optimization_level{ optimization_level },
+              m_isolation{ isolation } {
+            if (not m_socket.is_valid()) {
+                throw std::runtime_error{ "Unable to create socket." };
+            }
+            warm_up();
+            auto const address = make_socket_address(m_socket_path);
+            ::unlink(m_socket_path.c_str());
+            if (::bind(m_socket.get(), reinterpret_cast<sockaddr const*>(&address), sizeof(address)) != 0
+                or ::listen(m_socket.get(), SOMAXCONN) != 0) {
+                throw std::runtime_error{ std::format("Unable to listen on '{}'.", m_socket_path) };
+            }
+        }
+
+        CompileServer(CompileServer const& other) = delete;
+        CompileServer(CompileServer&& other) noexcept = delete;
+        CompileServer& operator=(CompileServer const& other) = delete;
+        CompileServer& operator=(CompileServer&& other) noexcept = delete;
+
+        ~CompileServer() {
+            ::unlink(m_socket_path.c_str());
+        }
+
+        // Compiles a script ahead of the first request for it. Clients send absolute paths, so the script is
+        // cached under its absolute path.
+        auto preload(std::filesystem::path const& path) -> void {
+            auto contents = utils::read_file(path);
+            if (not contents.has_value()) {
+                throw std::runtime_error{ std::format("Unable to read file '{}'.", path.string()) };
+            }
+            std::ignore = compile(std::filesystem::absolute(path).string(), std::move(contents).value());
+        }
+
+        [[noreturn]] auto serve() -> void {
+            // A client that goes away while its script is running must not take the server down with it.
+            std::signal(SIGPIPE, SIG_IGN);
+            auto connections = std::vector<FileDescriptor>{};
+            auto descriptors = std::vector<pollfd>{};
+            while (true) {
+                // Idle connections are only waited on here, so the timeouts only start once a request arrives.
+                descriptors.clear();
+                for (auto const& connection : connections) {
+                    descriptors.push_back(pollfd{ connection.get(), POLLIN, 0 });
+                }
+                if (connections.size() < max_num_connections) {
+                    descriptors.push_back(pollfd{ m_socket.get(), POLLIN, 0 });
+                }
+                if (::poll(descriptors.data(), descriptors.size(), -1) < 0) {
+                    continue;
+                }
+
+                for (auto i = 0uz; i < connections.size(); ++i) {
+                    if (descriptors.at(i).revents == 0) {
+                        continue;
+                    }
+                    try {
+                        if (not handle_request(connections.at(i).get())) {
+                            connections.at(i) = FileDescriptor{};
+                        }
+                    } catch (std::exception const& e) {
+                        std::println(stderr, "Dropped connection: {}", e.what());
+                        connections.at(i) = FileDescriptor{};
+                    }
+                }
+                std::erase_if(connections, [](FileDescriptor const& connection) { return not connection.is_valid(); });
+
+                if (descriptors.size() > connections.size() and descriptors.back().revents != 0) {
+                    accept_connection(connections);
+                }
+            }
+        }
+
+    private:
+        auto warm_up() -> void {
+            auto& interpreter = compile("<warm-up>", std::string{ warm_up_script });
+            auto const null_device = FileDescriptor{ ::open("/dev/null", O_WRONLY | O_CLOEXEC) };
+            if (null_device.is_valid()) {
+                run_in_process(interpreter, null_device.get());
+            }
+            m_programs.clear();
+        }
+
+        auto accept_connection(std::vector<FileDescriptor>& connections) -> void {
+            auto connection = FileDescriptor{ ::accept4(m_socket.get(), nullptr, nullptr, SOCK_CLOEXEC) };
+            if (not connection.is_valid()) {
+                return;
+            }
+            try {
+                set_timeouts(connection.get());
+            } catch (std::exception const& e) {
+                std::println(stderr, "Dropped connection: {}", e.what());
+                return;
+            }
+            connections.push_back(std::move(connection));
+        }
+
+        // Called when data has arrived on the connection. Returns `false` if the connection can't be used any
+        // further.
+        [[nodiscard]] auto handle_request(int const connection) -> bool {
+            auto header = ServerRequestHeader{};
+            auto const output = receive_with_file_descriptor(connection, as_writable_bytes(header));
+            if (not output.is_valid()) {
+                return false;
+            }
+            if (header.name_length > max_request_name_length or header.source_length > max_request_source_length) {
+                // The rest of the request is never read.
+                send_response(connection, "Request is too large.");
+                return false;
+            }
+            auto name = std::string(header.name_length, '\0');
+            auto source = std::string(header.source_length, '\0');
+            if (not receive_all(connection, name) or not receive_all(connection, source)) {
+                throw std::runtime_error{ "Connection closed unexpectedly." };
+            }
+
+            auto error = std::optional<std::string>{};
+            try {
+                if (header.kind == ServerRequestKind::RunFile) {
+                    auto contents = utils::read_file(name);
+                    if (not contents.has_value()) {
+                        throw std::runtime_error{ std::format("Unable to read file '{}'.", name) };
+                    }
+                    source = std::move(contents).value();
+                }
+                auto& interpreter = compile(std::move(name), std::move(source));
+                if (m_isolation == ServerIsolation::ForkPerScript) {
+                    // The child sends the response.
+                    return run_in_child(interpreter, connection, output.get());
+                }
+                run_in_process(interpreter, output.get());
+            } catch (std::exception const& e) {
+                error = e.what();
+            }
+            send_response(connection, error);
+            return true;
+        }
+
+        [[nodiscard]] auto compile(std::string name, std::string source) -> Interpreter& {
+            auto key = std::move(name);
+            auto const name_length = key.size();
+            key.push_back('\0');
+            key += source;
+
+            auto entry = m_programs.find(key);
+            if (entry == m_programs.end()) {
+                if (m_programs.size() >= max_num_cached_programs) {
+                    m_programs.clear();
+                }
+                // The compiled statements keep their source alive.
+                auto cache = type_checker::CompilationCache{};
+                auto program = cache.compile(key.substr(0, name_length), std::move(source));
+                auto interpreter = std::make_unique<Interpreter>(std::move(program), m_engine, m_optimization_level);
+                entry = m_programs.emplace(std::move(key), std::move(interpreter)).first;
+            }
+            return *entry->second;
+        }
+
+        auto run_in_process(Interpreter& interpreter, int const output) -> void {
+            auto const non_blocking = NonBlockingGuard{ output };
+            run_script(interpreter, output);
+        }
+
+        // Must be called while `output` is non-blocking, so that a client that doesn't read its output only stalls
+        // the script for `client_timeout`.
+        static auto run_script(Interpreter& interpreter, int const output) -> void {
+            auto sink = OutputSink::to_file_descriptor(output);
+            sink.set_write_timeout(client_timeout);
+            interpreter.run(sink);
+        }
+
+        // Returns `false` if the connection can't be used any further.
+        [[nodiscard]] auto run_in_child(Interpreter& interpreter, int const connection, int const output) -> bool {
+            // The child ends without running destructors, so the parent restores the flags even if the child
+            // crashes.
+            auto const non_blocking = NonBlockingGuard{ output };
+            // Buffered data would otherwise be written by both processes.
+            std::fflush(stdout);
+            std::fflush(stderr);
+            auto const child = ::fork();
+            if (child < 0) {
+                throw std::runtime_error{ "Unable to start a process for the script." };
+            }
+            if (child == 0) {
+                // The child must neither return into the server loop nor run the destructors of the server (which
+                // would remove the socket). It only exits with `EXIT_SUCCESS` after it has sent the response, and with
+                // `partial_response_status` if sending the response has failed midway.
+                auto status = EXIT_SUCCESS;
+                auto is_responding = false;
+                try {
+                    auto error = std::optional<std::string>{};
+                    try {
+                        run_script(interpreter, output);
+                    } catch (std::exception const& e) {
+                        error = e.what();
+                    } catch (...) {
+                        error = "Unknown error.";
+                    }
+                    is_responding = true;
+                    send_response(connection, error);
+                } catch (...) {
+                    status = is_responding ? partial_response_status : EXIT_FAILURE;
+                }
+                std::_Exit(status);
+            }
+
+            auto status = 0;
+            while (::waitpid(child, &status, 0) < 0) {
+                if (errno != EINTR) {
+                    throw std::runtime_error{ "Unable to wait for the process of the script." };
+                }
+            }
+            if (WIFEXITED(status) and WEXITSTATUS(status) == partial_response_status) {
+                // A second response would be out of sync with what the client has already received.
+                return false;
+            }
+            // Otherwise the child has not responded, and the client would wait forever.
+            if (WIFSIGNALED(status)) {
+                send_response(connection, std::format("Script terminated by signal {}.", WTERMSIG(status)));
+            } else if (not WIFEXITED(status) or WEXITSTATUS(status) != EXIT_SUCCESS) {
+                send_response(connection, "Script process failed without a response.");
+            }
+            return true;
+        }
+
+        static auto send_response(int const connection, std::optional<std::string> error) -> void {
+            auto response = ServerResponseHeader{ .success = true, .message_length = 0 };
+            if (error.has_value()) {
+                error->resize(std::min<usize>(error->size(), std::numeric_limits<std::uint32_t>::max()));
+                response.success = false;
+                response.message_length = static_cast<std::uint32_t>(error->size());
+            }
+            send_all(connection, as_bytes(response));
+            if (error.has_value()) {
+                send_all(connection, *error);
+            }
+        }
+
+        // Applies to receiving requests and sending responses. Writing the output of a script has its own timeout.
+        static auto set_timeouts(int const connection) -> void {
+            auto const timeout = timeval{ .tv_sec = client_timeout.count(), .tv_usec = 0 };
+            if (::setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) != 0
+                or ::setsockopt(connection, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)) != 0) {
+                throw std::runtime_error{ "Unable to set connection timeouts." };
+            }
+        }
+    };
+
+} // namespace interpreter
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "engine.hpp"
+#include "output_sink.hpp"
+#include <expected>
+#include <ir/optimization_level.hpp>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <utils/diagnostics.hpp>
+
+namespace interpreter {
+    struct CompiledProgram;
+}
+
+// The API for embedding the interpreter: a script is compiled once and can then be run any number of times, from
+// any number of threads.
+//
+// This header (unlike the rest of the library) can be included by hosts that are built with `-fno-exceptions`: its
+// inline code neither throws nor catches. Such hosts use the `try_*` functions, which catch every exception inside
+// the library, and let `try_run()` flush the sink instead of calling `OutputSink::flush()` themselves (see
+// `no_exceptions_example.cpp`).
+namespace backseat {
+
+    struct CompileOptions final {
+        std::string filename{ "<script>" }; // Only used in error messages.
+        interpreter::Engine engine{ interpreter::Engine::Tree };
+        ir::OptimizationLevel optimization_level{ ir::OptimizationLevel::O2 };
+    };
+
+    // A compiled script. It owns everything it refers to (the source is not needed after compilation) and is never
+    // modified, so copies are cheap and it can be run by many threads at once.
+    class Program final {
+    private:
+        std::shared_ptr<interpreter::CompiledProgram const> m_program;
+
+    public:
+        [[nodiscard]] explicit Program(std::shared_ptr<interpreter::CompiledProgram const> program)
+            : m_program{ std::move(program) } { }
+
+        [[nodiscard]] auto compiled() const -> std::shared_ptr<interpreter::CompiledProgram const> const& {
+            return m_program;
+        }
+    };
+
+    // Throws the error of the first stage that fails. Can be called concurrently.
+    [[nodiscard]] auto compile(std::string_view source, CompileOptions const& options = {}) -> Program;
+
+    // Like `compile()`, but reports errors to `diagnostics` instead of throwing.
+    [[nodiscard]] auto try_compile(
+            std::string_view source,
+            utils::Diagnostics& diagnostics,
+            CompileOptions const& options = {}
+    ) -> std::expected<Program, utils::DiagnosticKind>;
+
+    // Every call has its own interpreter state, so a program can be run concurrently as long as every thread
+    // writes to its own sink. The sink is flushed at the end, also if a runtime error is thrown.
+    auto run(Program const& program, interpreter::OutputSink& output) -> void;
+
+    // Like `run()`, but reports runtime errors to `diagnostics` instead of throwing.
+    [[nodiscard]] auto try_run(
+            Program const& program,
+            interpreter::OutputSink& output,
+            utils::Diagnostics& diagnostics
+    ) -> std::expected<void, utils::DiagnosticKind>;
+
+} // namespace backseat
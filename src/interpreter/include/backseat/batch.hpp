@@ -0,0 +1,75 @@
+#pragma once
+
+#include "backseat.hpp"
+#include <algorithm>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utils/diagnostics.hpp>
+#include <utils/thread_pool.hpp>
+#include <utils/types.hpp>
+#include <utility>
+#include <vector>
+
+namespace backseat {
+
+    struct BatchScript final {
+        std::string_view filename; // Only used in error messages.
+        std::string_view source;
+    };
+
+    struct BatchResult final {
+        std::string output;
+        utils::Diagnostics diagnostics; // The errors of compiling or running the script.
+
+        [[nodiscard]] auto succeeded() const -> bool {
+            return diagnostics.empty();
+        }
+    };
+
+    // Compiles and runs many independent scripts on a work-stealing pool. Every worker owns its context, so workers
+    // share no mutable state besides the (internally synchronized) tables of the type checker. The output of every
+    // script is collected in its own result, so outputs never interleave, no matter which worker ran the script.
+    class BatchExecutor final {
+    private:
+        // Aligned to a cache line, so that workers don't slow each other down by writing to the same one.
+        struct alignas(64) WorkerContext final {
+            // The size of the output of the previous script. The output of the next one is written into its result
+            // directly, and reserving this much up front means that it rarely needs to grow.
+            usize output_capacity{ 0 };
+        };
+
+        utils::WorkStealingPool m_pool;
+        CompileOptions m_options;
+        std::vector<WorkerContext> m_workers;
+
+    public:
+        // `options.filename` is replaced by the filename of each script. A worker count of zero is treated as one.
+        [[nodiscard]] explicit BatchExecutor(
+                CompileOptions options = {},
+                usize const num_workers = std::max(usize{ std::thread::hardware_concurrency() }, 1uz)
+        )
+            : m_pool{ std::max(num_workers, 1uz) },
+              m_options{ std::move(options) },
+              m_workers(m_pool.num_workers()) { }
+
+        [[nodiscard]] auto num_workers() const -> usize {
+            return m_pool.num_workers();
+        }
+
+        // The results are in the same order as the scripts.
+        [[nodiscard]] auto run(std::span<BatchScript const> scripts) -> std::vector<BatchResult>;
+
+        // Runs programs that have been compiled before. The results are in the same order as the programs.
+        [[nodiscard]] auto run(std::span<Program const> programs) -> std::vector<BatchResult>;
+
+    private:
+        [[nodiscard]] auto execute(
+                usize count,
+                std::function<void(usize, interpreter::OutputSink&, utils::Diagnostics&)> const& function
+        ) -> std::vector<BatchResult>;
+    };
+
+} // namespace backseat
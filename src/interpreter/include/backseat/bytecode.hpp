@@ -0,0 +1,167 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <experimental/meta>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_checker/type_checker.hpp>
+#include <vector>
+
+namespace interpreter {
+
+    // Every register holds an unboxed `u64`. Registers of string type hold an index into `BytecodeProgram::strings`.
+    enum class Opcode : std::uint8_t {
+        LoadConstant, // a = constants[b]
+        LoadString,   // a = b
+        Add,          // a = b + c
+        Subtract,     // a = b - c
+        Multiply,     // a = b * c
+        Divide,       // a = b / c
+        Modulo,       // a = b mod c
+        PrintU64,     // print(a)
+        PrintString,  // print(strings[a])
+        PrintNewline, // println()
+        Halt,
+    };
+
+    inline constexpr auto num_opcodes = enumerators_of(dealias(^^Opcode)).size();
+
+    struct Instruction final {
+        Opcode opcode;
+        std::uint32_t a;
+        std::uint32_t b;
+        std::uint32_t c;
+    };
+
+    struct BytecodeProgram final {
+        std::vector<Instruction> instructions;
+        std::vector<std::uint64_t> constants;
+        std::vector<std::string> strings;
+        std::uint32_t num_registers{ 0 };
+    };
+
+    // Translates a list of typed statements into register-based bytecode. The registers of an expression tree are
+    // allocated like a stack: the result of an expression is stored in the lowest free register.
+    class BytecodeCompiler final {
+    private:
+        BytecodeProgram m_program;
+
+    public:
+        [[nodiscard]] auto compile(std::span<std::shared_ptr<type_checker::Statement const> const> const statements)
+                -> BytecodeProgram {
+            m_program = BytecodeProgram{};
+            for (auto const& statement : statements) {
+                compile_statement(*statement);
+            }
+            emit(Opcode::Halt);
+            return std::move(m_program);
+        }
+
+    private:
+        auto emit(Opcode const opcode, std::uint32_t const a = 0, std::uint32_t const b = 0, std::uint32_t const c = 0)
+                -> void {
+            m_program.instructions.push_back(Instruction{ opcode, a, b, c });
+        }
+
+        auto use_register(std::uint32_t const target) -> void {
+            m_program.num_registers = std::max(m_program.num_registers, target + 1);
+        }
+
+        auto compile_print_argument(type_checker::Expression const& argument) -> void {
+            compile_expression(argument, 0);
+            if (argument.data_type() == type_checker::string_type) {
+                emit(Opcode::PrintString, 0);
+            } else if (argument.data_type() == type_checker::u64_type) {
+                emit(Opcode::PrintU64, 0);
+            } else {
+                throw std::runtime_error{ "Unsupported data type for printing." };
+            }
+        }
+
+        auto compile(type_checker::Print const& statement) -> void {
+            compile_print_argument(*statement.argument());
+        }
+
+        auto compile(type_checker::Println const& statement) -> void {
+            compile_print_argument(*statement.argument());
+            emit(Opcode::PrintNewline);
+        }
+
+        auto compile(type_checker::StringLiteral const& expression, std::uint32_t const target) -> void {
+            use_register(target);
+            m_program.strings.emplace_back(expression.value());
+            emit(Opcode::LoadString, target, static_cast<std::uint32_t>(m_program.strings.size() - 1));
+        }
+
+        auto compile(type_checker::UnsignedIntegerLiteral const& expression, std::uint32_t const target) -> void {
+            use_register(target);
+            m_program.constants.push_back(expression.value());
+            emit(Opcode::LoadConstant, target, static_cast<std::uint32_t>(m_program.constants.size() - 1));
+        }
+
+        auto compile(type_checker::BinaryOperator const& expression, std::uint32_t const target) -> void {
+            compile_expression(expression.lhs(), target);
+            compile_expression(expression.rhs(), target + 1);
+            emit(opcode_of(expression.operator_type()), target, target, target + 1);
+        }
+
+        [[nodiscard]] static auto opcode_of(lexer::TokenType const operator_token_type) -> Opcode {
+            switch (operator_token_type) {
+                case lexer::TokenType::Plus:
+                    return Opcode::Add;
+                case lexer::TokenType::Minus:
+                    return Opcode::Subtract;
+                case lexer::TokenType::Asterisk:
+                    return Opcode::Multiply;
+                case lexer::TokenType::ForwardSlash:
+                    return Opcode::Divide;
+                case lexer::TokenType::Mod:
+                    return Opcode::Modulo;
+                default:
+                    throw std::runtime_error{ "Unsupported binary operator." };
+            }
+        }
+
+        auto compile_statement(type_checker::Statement const& statement) -> void {
+            static constexpr auto context = std::meta::access_context::current();
+            template for (constexpr auto member : std::define_static_array(members_of(^^type_checker, context))) {
+                if constexpr (is_type(member) and is_class_type(member)) {
+                    static constexpr auto does_inherit_base =
+                            std::ranges::any_of(bases_of(member, context), [](auto const& base) {
+                                return is_same_type(type_of(base), ^^type_checker::Statement);
+                            });
+                    if constexpr (does_inherit_base) {
+                        auto const downcasted = dynamic_cast<[:member:] const*>(std::addressof(statement));
+                        if (downcasted != nullptr) {
+                            return compile(*downcasted);
+                        }
+                    }
+                }
+            }
+            throw std::runtime_error{ "Unreachable" };
+        }
+
+        auto compile_expression(type_checker::Expression const& expression, std::uint32_t const target) -> void {
+            static constexpr auto context = std::meta::access_context::current();
+            template for (constexpr auto member : std::define_static_array(members_of(^^type_checker, context))) {
+                if constexpr (is_type(member) and is_class_type(member)) {
+                    static constexpr auto does_inherit_base =
+                            std::ranges::any_of(bases_of(member, context), [](auto const& base) {
+                                return is_same_type(type_of(base), ^^type_checker::Expression);
+                            });
+                    if constexpr (does_inherit_base) {
+                        auto const downcasted = dynamic_cast<[:member:] const*>(std::addressof(expression));
+                        if (downcasted != nullptr) {
+                            return compile(*downcasted, target);
+                        }
+                    }
+                }
+            }
+            throw std::runtime_error{ "Unreachable" };
+        }
+    };
+
+} // namespace interpreter
@@ -0,0 +1,219 @@
+#pragma once
+
+#include "output_sink.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <experimental/meta>
+#include <functional>
+#include <interpreter/error.hpp>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <tl/optional.hpp>
+#include <type_checker/type_checker.hpp>
+#include <utility>
+#include <vector>
+
+namespace interpreter {
+
+    // Statements write to the sink they are given, so a compiled program can be run with any sink.
+    using StatementClosure = std::function<void(OutputSink&)>;
+    using U64Closure = std::function<std::uint64_t()>;
+
+    struct ClosureProgram final {
+        std::vector<StatementClosure> statements;
+    };
+
+    // Translates typed statements into trees of closures. All dispatching on node types and data types happens
+    // once during compilation, so every closure is specialized for the exact operation it performs.
+    class ClosureCompiler final {
+    private:
+        struct Add final {
+            [[nodiscard]] static auto operator()(std::uint64_t const lhs, std::uint64_t const rhs) -> std::uint64_t {
+                return lhs + rhs;
+            }
+        };
+
+        struct Subtract final {
+            [[nodiscard]] static auto operator()(std::uint64_t const lhs, std::uint64_t const rhs) -> std::uint64_t {
+                return lhs - rhs;
+            }
+        };
+
+        struct Multiply final {
+            [[nodiscard]] static auto operator()(std::uint64_t const lhs, std::uint64_t const rhs) -> std::uint64_t {
+                return lhs * rhs;
+            }
+        };
+
+        struct Divide final {
+            [[nodiscard]] static auto operator()(std::uint64_t const lhs, std::uint64_t const rhs) -> std::uint64_t {
+                if (rhs == 0) {
+                    throw InterpreterError{ "Division by zero." };
+                }
+                return lhs / rhs;
+            }
+        };
+
+        struct Modulo final {
+            [[nodiscard]] static auto operator()(std::uint64_t const lhs, std::uint64_t const rhs) -> std::uint64_t {
+                if (rhs == 0) {
+                    throw InterpreterError{ "Division by zero." };
+                }
+                return lhs % rhs;
+            }
+        };
+
+    public:
+        [[nodiscard]] auto compile(std::span<std::shared_ptr<type_checker::Statement const> const> const statements)
+                -> ClosureProgram {
+            auto program = ClosureProgram{};
+            program.statements.reserve(statements.size());
+            for (auto const& statement : statements) {
+                program.statements.push_back(compile_statement(*statement));
+            }
+            return program;
+        }
+
+    private:
+        [[nodiscard]] auto compile_print(type_checker::Expression const& argument, bool const append_newline)
+                -> StatementClosure {
+            if (argument.data_type() == type_checker::string_type) {
+                auto text = compile_string_constant(argument);
+                if (append_newline) {
+                    text += '\n';
+                }
+                return [text = std::move(text)](OutputSink& output) { output.write(text); };
+            }
+            if (argument.data_type() != type_checker::u64_type) {
+                throw std::runtime_error{ "Unsupported data type for printing." };
+            }
+            if (auto const constant = constant_value(argument); constant.has_value()) {
+                auto text = std::to_string(constant.value());
+                if (append_newline) {
+                    text += '\n';
+                }
+                return [text = std::move(text)](OutputSink& output) { output.write(text); };
+            }
+            if (append_newline) {
+                return [value = compile_u64_expression(argument)](OutputSink& output) {
+                    output.write_u64(value());
+                    output.write('\n');
+                };
+            }
+            return [value = compile_u64_expression(argument)](OutputSink& output) { output.write_u64(value()); };
+        }
+
+        [[nodiscard]] auto compile(type_checker::Print const& statement) -> StatementClosure {
+            return compile_print(*statement.argument(), false);
+        }
+
+        [[nodiscard]] auto compile(type_checker::Println const& statement) -> StatementClosure {
+            return compile_print(*statement.argument(), true);
+        }
+
+        [[nodiscard]] auto compile(type_checker::UnsignedIntegerLiteral const& expression) -> U64Closure {
+            return [value = expression.value()] { return value; };
+        }
+
+        [[nodiscard]] auto compile(type_checker::BinaryOperator const& expression) -> U64Closure {
+            switch (expression.operator_type()) {
+                case lexer::TokenType::Plus:
+                    return compile_binary<Add>(expression);
+                case lexer::TokenType::Minus:
+                    return compile_binary<Subtract>(expression);
+                case lexer::TokenType::Asterisk:
+                    return compile_binary<Multiply>(expression);
+                case lexer::TokenType::ForwardSlash:
+                    return compile_binary<Divide>(expression);
+                case lexer::TokenType::Mod:
+                    return compile_binary<Modulo>(expression);
+                default:
+                    throw std::runtime_error{ "Unsupported binary operator." };
+            }
+        }
+
+        // Only reachable for expressions that do not evaluate to `U64`.
+        [[nodiscard]] auto compile(type_checker::Expression const&) -> U64Closure {
+            throw std::runtime_error{ "Unreachable" };
+        }
+
+        template<typename Operation>
+        [[nodiscard]] auto compile_binary(type_checker::BinaryOperator const& expression) -> U64Closure {
+            auto const lhs_constant = constant_value(expression.lhs());
+            auto const rhs_constant = constant_value(expression.rhs());
+            if (rhs_constant.has_value()) {
+                if (lhs_constant.has_value()) {
+                    // Evaluated at runtime anyway so that errors like a division by zero are reported in order.
+                    return [lhs = lhs_constant.value(), rhs = rhs_constant.value()] {
+                        return Operation{}(lhs, rhs);
+                    };
+                }
+                return [lhs = compile_u64_expression(expression.lhs()), rhs = rhs_constant.value()] {
+                    return Operation{}(lhs(), rhs);
+                };
+            }
+            return [lhs = compile_u64_expression(expression.lhs()), rhs = compile_u64_expression(expression.rhs())] {
+                return Operation{}(lhs(), rhs());
+            };
+        }
+
+        [[nodiscard]] static auto constant_value(type_checker::Expression const& expression)
+                -> tl::optional<std::uint64_t> {
+            auto const literal = dynamic_cast<type_checker::UnsignedIntegerLiteral const*>(std::addressof(expression));
+            if (literal == nullptr) {
+                return tl::nullopt;
+            }
+            return literal->value();
+        }
+
+        // String literals are the only expressions of type `String`.
+        [[nodiscard]] static auto compile_string_constant(type_checker::Expression const& expression) -> std::string {
+            auto const literal = dynamic_cast<type_checker::StringLiteral const*>(std::addressof(expression));
+            if (literal == nullptr) {
+                throw std::runtime_error{ "Unsupported expression of type String." };
+            }
+            return std::string{ literal->value() };
+        }
+
+        [[nodiscard]] auto compile_statement(type_checker::Statement const& statement) -> StatementClosure {
+            static constexpr auto context = std::meta::access_context::current();
+            template for (constexpr auto member : std::define_static_array(members_of(^^type_checker, context))) {
+                if constexpr (is_type(member) and is_class_type(member)) {
+                    static constexpr auto does_inherit_base =
+                            std::ranges::any_of(bases_of(member, context), [](auto const& base) {
+                                return is_same_type(type_of(base), ^^type_checker::Statement);
+                            });
+                    if constexpr (does_inherit_base) {
+                        auto const downcasted = dynamic_cast<[:member:] const*>(std::addressof(statement));
+                        if (downcasted != nullptr) {
+                            return compile(*downcasted);
+                        }
+                    }
+                }
+            }
+            throw std::runtime_error{ "Unreachable" };
+        }
+
+        [[nodiscard]] auto compile_u64_expression(type_checker::Expression const& expression) -> U64Closure {
+            static constexpr auto context = std::meta::access_context::current();
+            template for (constexpr auto member : std::define_static_array(members_of(^^type_checker, context))) {
+                if constexpr (is_type(member) and is_class_type(member)) {
+                    static constexpr auto does_inherit_base =
+                            std::ranges::any_of(bases_of(member, context), [](auto const& base) {
+                                return is_same_type(type_of(base), ^^type_checker::Expression);
+                            });
+                    if constexpr (does_inherit_base) {
+                        auto const downcasted = dynamic_cast<[:member:] const*>(std::addressof(expression));
+                        if (downcasted != nullptr) {
+                            return compile(*downcasted);
+                        }
+                    }
+                }
+            }
+            throw std::runtime_error{ "Unreachable" };
+        }
+    };
+
+} // namespace interpreter
@@ -0,0 +1,13 @@
+#pragma once
+
+namespace interpreter {
+
+    enum class Engine {
+        Tree,     // Walks the typed tree.
+        Bytecode, // Compiles the typed tree to register-based bytecode and runs it in a `VirtualMachine`.
+        Jit,      // Compiles the typed tree to native x86-64 code. Falls back to `Tree` for unsupported statements.
+        Closures, // Compiles the typed tree to specialized closures.
+        Ir,       // Lowers the typed tree to SSA IR, optimizes it and runs it in an `IrEvaluator`.
+    };
+
+} // namespace interpreter
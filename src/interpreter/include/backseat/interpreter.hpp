@@ -0,0 +1,443 @@
+#pragma once
+
+#include "bytecode.hpp"
+#include "closures.hpp"
+#include "engine.hpp"
+#include "ir_evaluator.hpp"
+#include "jit.hpp"
+#include "kernels.hpp"
+#include "output_sink.hpp"
+#include "values.hpp"
+#include "virtual_machine.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <expected>
+#include <experimental/meta>
+#include <format>
+#include <interpreter/error.hpp>
+#include <ir/lowering.hpp>
+#include <ir/passes.hpp>
+#include <iterator>
+#include <memory>
+#include <parser/parser.hpp>
+#include <print>
+#include <string>
+#include <type_checker/type_checker.hpp>
+#include <utility>
+#include <utils/diagnostics.hpp>
+#include <utils/thread_pool.hpp>
+#include <vector>
+
+namespace interpreter {
+
+    // A typed program together with everything the engine has compiled it to. It is never modified after
+    // compilation, so any number of interpreters can run it, also concurrently.
+    struct CompiledProgram final {
+        std::vector<std::shared_ptr<type_checker::Statement const>> statements;
+        Engine engine{ Engine::Tree };
+        BytecodeProgram bytecode;
+        JitProgram jit_program;
+        ClosureProgram closure_program;
+        ir::Program ir_program;
+
+        [[nodiscard]] static auto compile(
+                std::vector<std::shared_ptr<type_checker::Statement const>> statements,
+                Engine const engine = Engine::Tree,
+                ir::OptimizationLevel const optimization_level = ir::OptimizationLevel::O2
+        ) -> std::shared_ptr<CompiledProgram const> {
+            auto program = std::make_shared<CompiledProgram>();
+            program->statements = std::move(statements);
+            program->engine = engine;
+            switch (engine) {
+                case Engine::Tree:
+                    break;
+                case Engine::Bytecode: {
+                    auto compiler = BytecodeCompiler{};
+                    program->bytecode = compiler.compile(program->statements);
+                    break;
+                }
+                case Engine::Jit: {
+                    auto compiler = JitCompiler{};
+                    program->jit_program = compiler.compile(program->statements);
+                    break;
+                }
+                case Engine::Closures: {
+                    auto compiler = ClosureCompiler{};
+                    program->closure_program = compiler.compile(program->statements);
+                    break;
+                }
+                case Engine::Ir:
+                    program->ir_program = ir::optimize(ir::lower(program->statements), optimization_level);
+                    break;
+            }
+            return program;
+        }
+    };
+
+    class Interpreter final {
+    private:
+        std::shared_ptr<CompiledProgram const> m_program;
+        std::vector<std::unique_ptr<parser::Statement>> m_parse_tree;
+        type_checker::TypeAnnotations m_annotations;
+        // Indexed by `type_checker::ExpressionId`. Hash-consed expressions are evaluated once per run. The ids of a
+        // program are dense unless its pool outlives several programs, and even then the pool recycles the ids of
+        // destroyed nodes, so the table stays proportional to the number of living expressions.
+        std::vector<tl::optional<std::uint64_t>> m_memoized_values;
+        OutputSink m_output{ OutputSink::to_stdout() };
+
+    public:
+        [[nodiscard]] explicit Interpreter(
+                std::vector<std::unique_ptr<type_checker::Statement>> program,
+                Engine const engine = Engine::Tree,
+                ir::OptimizationLevel const optimization_level = ir::OptimizationLevel::O2
+        )
+            : Interpreter{
+                  std::vector<std::shared_ptr<type_checker::Statement const>>(
+                          std::make_move_iterator(program.begin()),
+                          std::make_move_iterator(program.end())
+                  ),
+                  engine,
+                  optimization_level,
+              } { }
+
+        // Runs statements that may be shared with other programs, e.g. by a `type_checker::CompilationCache`.
+        [[nodiscard]] explicit Interpreter(
+                std::vector<std::shared_ptr<type_checker::Statement const>> program,
+                Engine const engine = Engine::Tree,
+                ir::OptimizationLevel const optimization_level = ir::OptimizationLevel::O2
+        )
+            : Interpreter{ CompiledProgram::compile(std::move(program), engine, optimization_level) } { }
+
+        // Runs a program that may be shared with other interpreters.
+        [[nodiscard]] explicit Interpreter(std::shared_ptr<CompiledProgram const> program)
+            : m_program{ std::move(program) } { }
+
+        // Runs the parse tree directly. The data types of its expressions are looked up in the given side table.
+        [[nodiscard]] explicit Interpreter(
+                std::vector<std::unique_ptr<parser::Statement>> parse_tree,
+                type_checker::TypeAnnotations annotations
+        )
+            : m_program{ std::make_shared<CompiledProgram const>() },
+              m_parse_tree{ std::move(parse_tree) },
+              m_annotations{ std::move(annotations) } { }
+
+        auto run() -> void {
+            m_memoized_values.clear();
+            try {
+                run_engine();
+            } catch (...) {
+                // The output of everything before the error must still be visible.
+                m_output.flush();
+                throw;
+            }
+            m_output.flush();
+        }
+
+        // Like `run()`, but writes the output to `output` instead of stdout.
+        auto run(OutputSink& output) -> void {
+            std::swap(m_output, output);
+            try {
+                run();
+            } catch (...) {
+                std::swap(m_output, output);
+                throw;
+            }
+            std::swap(m_output, output);
+        }
+
+        // Evaluates the top-level statements in parallel. The output of every statement is buffered and written to
+        // stdout in program order. A runtime error is reported after the output of all preceding statements, just
+        // like with `run()`. Only the `Tree` engine on a typed program supports this, everything else runs serially.
+        auto run(utils::WorkStealingPool& pool) -> void {
+            if (m_program->engine != Engine::Tree or not m_parse_tree.empty()) {
+                run();
+                return;
+            }
+
+            struct StatementResult final {
+                std::string output;
+                std::exception_ptr error;
+            };
+
+            // Statements are distributed in chunks to keep the scheduling overhead low for large programs.
+            static constexpr auto chunk_size = 64uz;
+            auto const& statements = m_program->statements;
+            auto const num_chunks = (statements.size() + chunk_size - 1) / chunk_size;
+
+            // Every worker has its own interpreter state (e.g. for memoization).
+            auto workers = std::vector<Interpreter>{};
+            workers.reserve(pool.num_workers());
+            for (auto i = 0uz; i < pool.num_workers(); ++i) {
+                workers.emplace_back(m_program);
+            }
+
+            auto results = std::vector<StatementResult>(statements.size());
+            // Statements after the first failing one are never committed, so there is no need to evaluate them.
+            auto first_error_index = std::atomic{ statements.size() };
+            pool.for_each_index(num_chunks, [&](usize const chunk_index, usize const worker_index) {
+                auto& worker = workers.at(worker_index);
+                auto const begin = chunk_index * chunk_size;
+                auto const end = std::min(begin + chunk_size, statements.size());
+                for (auto i = begin; i < end and i < first_error_index.load(std::memory_order_relaxed); ++i) {
+                    auto& result = results.at(i);
+                    worker.m_output = OutputSink::to_memory(result.output);
+                    try {
+                        worker.interpret_statement(*statements.at(i));
+                    } catch (...) {
+                        result.error = std::current_exception();
+                        auto expected = first_error_index.load(std::memory_order_relaxed);
+                        while (i < expected and not first_error_index.compare_exchange_weak(expected, i)) {
+                            // `expected` now holds the current value, so we try again.
+                        }
+                    }
+                }
+            });
+
+            for (auto const& [output, error] : results) {
+                m_output.write(output);
+                if (error != nullptr) {
+                    m_output.flush();
+                    std::rethrow_exception(error);
+                }
+            }
+            m_output.flush();
+        }
+
+        // Like `run()`, but reports runtime errors to `diagnostics` instead of throwing.
+        [[nodiscard]] auto try_run(utils::Diagnostics& diagnostics) -> std::expected<void, utils::DiagnosticKind> {
+            return try_invoke(diagnostics, [this] { run(); });
+        }
+
+        [[nodiscard]] auto try_run(OutputSink& output, utils::Diagnostics& diagnostics)
+                -> std::expected<void, utils::DiagnosticKind> {
+            return try_invoke(diagnostics, [&] { run(output); });
+        }
+
+        [[nodiscard]] auto try_run(utils::WorkStealingPool& pool, utils::Diagnostics& diagnostics)
+                -> std::expected<void, utils::DiagnosticKind> {
+            return try_invoke(diagnostics, [&] { run(pool); });
+        }
+
+    private:
+        [[nodiscard]] static auto try_invoke(utils::Diagnostics& diagnostics, auto const& function)
+                -> std::expected<void, utils::DiagnosticKind> {
+            try {
+                function();
+                return {};
+            } catch (std::exception const& error) {
+                // Besides `InterpreterError`, e.g. `std::bad_alloc` or a failed write to the output.
+                diagnostics.report(utils::DiagnosticKind::RuntimeError, error.what());
+            } catch (...) {
+                diagnostics.report(utils::DiagnosticKind::RuntimeError, "Unknown error.");
+            }
+            return std::unexpected{ utils::DiagnosticKind::RuntimeError };
+        }
+
+        auto run_engine() -> void {
+            switch (m_program->engine) {
+                case Engine::Tree:
+                    for (auto const& statement : m_program->statements) {
+                        interpret_statement(*statement);
+                    }
+                    for (auto const& statement : m_parse_tree) {
+                        interpret_annotated_statement(*statement);
+                    }
+                    break;
+                case Engine::Bytecode: {
+                    auto virtual_machine = VirtualMachine{};
+                    virtual_machine.run(m_program->bytecode, m_output);
+                    break;
+                }
+                case Engine::Jit:
+                    run_jit_program();
+                    break;
+                case Engine::Closures:
+                    for (auto const& statement : m_program->closure_program.statements) {
+                        statement(m_output);
+                    }
+                    break;
+                case Engine::Ir: {
+                    auto evaluator = IrEvaluator{};
+                    evaluator.run(m_program->ir_program, m_output);
+                    break;
+                }
+            }
+        }
+
+        auto run_jit_program() -> void {
+            for (auto const& [function, begin, end] : m_program->jit_program.segments()) {
+                if (function == nullptr) {
+                    for (auto i = begin; i < end; ++i) {
+                        interpret_statement(*m_program->statements.at(i));
+                    }
+                    continue;
+                }
+                switch (function(std::addressof(m_output))) {
+                    case JitStatus::Success:
+                        break;
+                    case JitStatus::DivisionByZero:
+                        throw InterpreterError{ "Division by zero." };
+                    case JitStatus::OutputError:
+                        throw InterpreterError{ "Unable to write output." };
+                }
+            }
+        }
+
+        auto print_value(Value const value) -> void {
+            switch (value.data_type()) {
+                using enum type_checker::BuiltinDataType;
+
+                case String:
+                    // Strings refer to the literals of the program (or its annotations), which outlive the run.
+                    // `run()` flushes before it returns.
+                    m_output.write_borrowed(value.get<String>());
+                    break;
+                case U64:
+                    m_output.write_u64(value.get<U64>());
+                    break;
+                default:
+                    throw InterpreterError{ "Unsupported builtin data type." };
+            }
+        }
+
+        auto interpret(type_checker::Print const& statement) -> void {
+            print_value(evaluate_expression(*statement.argument()));
+        }
+
+        auto interpret(type_checker::Println const& statement) -> void {
+            print_value(evaluate_expression(*statement.argument()));
+            m_output.write('\n');
+        }
+
+        auto interpret(parser::Print const& statement) -> void {
+            print_value(evaluate_annotated_expression(statement.argument()));
+        }
+
+        auto interpret(parser::Println const& statement) -> void {
+            print_value(evaluate_annotated_expression(statement.argument()));
+            m_output.write('\n');
+        }
+
+        auto interpret_statement(type_checker::Statement const& statement) -> void {
+            static constexpr auto context = std::meta::access_context::current();
+            template for (constexpr auto member : std::define_static_array(members_of(^^type_checker, context))) {
+                if constexpr (is_type(member) and is_class_type(member)) {
+                    static constexpr auto does_inherit_base =
+                            std::ranges::any_of(bases_of(member, context), [](auto const& base) {
+                                return is_same_type(type_of(base), ^^type_checker::Statement);
+                            });
+                    if constexpr (does_inherit_base) {
+                        auto const downcasted = dynamic_cast<[:member:] const*>(std::addressof(statement));
+                        if (downcasted != nullptr) {
+                            return interpret(*downcasted);
+                        }
+                    }
+                }
+            }
+        }
+
+        auto evaluate(type_checker::StringLiteral const& expression) -> Value {
+            return Value::string(expression.value());
+        }
+
+        auto evaluate(type_checker::UnsignedIntegerLiteral const& expression) -> Value {
+            return Value::u64(expression.value());
+        }
+
+        auto evaluate(type_checker::BinaryOperator const& expression) -> Value {
+            auto const id = expression.id();
+            if (id < m_memoized_values.size() and m_memoized_values[id].has_value()) {
+                return Value::u64(m_memoized_values[id].value());
+            }
+            auto const lhs = evaluate_expression(expression.lhs());
+            auto const rhs = evaluate_expression(expression.rhs());
+            auto const result = binary_operator_kernels[expression.kernel()](lhs, rhs);
+            if (result.data_type() == type_checker::BuiltinDataType::U64) {
+                if (id >= m_memoized_values.size()) {
+                    m_memoized_values.resize(id + 1);
+                }
+                m_memoized_values[id] = result.get<type_checker::BuiltinDataType::U64>();
+            }
+            return result;
+        }
+
+        auto evaluate(parser::StringLiteral const& expression) -> Value {
+            return Value::string(m_annotations.string_value(expression.id()));
+        }
+
+        auto evaluate(parser::UnsignedIntegerLiteral const& expression) -> Value {
+            return Value::u64(expression.value());
+        }
+
+        auto evaluate(parser::BinaryOperator const& expression) -> Value {
+            auto const lhs = evaluate_annotated_expression(expression.lhs());
+            auto const rhs = evaluate_annotated_expression(expression.rhs());
+            auto const kernel = type_checker::BinaryOperator::get_kernel(
+                    m_annotations[expression.lhs().id()],
+                    expression.operator_token().type(),
+                    m_annotations[expression.rhs().id()]
+            );
+            return binary_operator_kernels[kernel](lhs, rhs);
+        }
+
+        auto evaluate_expression(type_checker::Expression const& expression) -> Value {
+            static constexpr auto context = std::meta::access_context::current();
+            template for (constexpr auto member : std::define_static_array(members_of(^^type_checker, context))) {
+                if constexpr (is_type(member) and is_class_type(member)) {
+                    static constexpr auto does_inherit_base =
+                            std::ranges::any_of(bases_of(member, context), [](auto const& base) {
+                                return is_same_type(type_of(base), ^^type_checker::Expression);
+                            });
+                    if constexpr (does_inherit_base) {
+                        auto const downcasted = dynamic_cast<[:member:] const*>(std::addressof(expression));
+                        if (downcasted != nullptr) {
+                            return evaluate(*downcasted);
+                        }
+                    }
+                }
+            }
+            throw std::runtime_error{ "Unreachable" };
+        }
+
+        auto interpret_annotated_statement(parser::Statement const& statement) -> void {
+            static constexpr auto context = std::meta::access_context::current();
+            template for (constexpr auto member : std::define_static_array(members_of(^^parser, context))) {
+                if constexpr (is_type(member) and is_class_type(member)) {
+                    static constexpr auto does_inherit_base =
+                            std::ranges::any_of(bases_of(member, context), [](auto const& base) {
+                                return is_same_type(type_of(base), ^^parser::Statement);
+                            });
+                    if constexpr (does_inherit_base) {
+                        auto const downcasted = dynamic_cast<[:member:] const*>(std::addressof(statement));
+                        if (downcasted != nullptr) {
+                            return interpret(*downcasted);
+                        }
+                    }
+                }
+            }
+        }
+
+        auto evaluate_annotated_expression(parser::Expression const& expression) -> Value {
+            static constexpr auto context = std::meta::access_context::current();
+            template for (constexpr auto member : std::define_static_array(members_of(^^parser, context))) {
+                if constexpr (is_type(member) and is_class_type(member)) {
+                    static constexpr auto does_inherit_base =
+                            std::ranges::any_of(bases_of(member, context), [](auto const& base) {
+                                return is_same_type(type_of(base), ^^parser::Expression);
+                            });
+                    if constexpr (does_inherit_base) {
+                        auto const downcasted = dynamic_cast<[:member:] const*>(std::addressof(expression));
+                        if (downcasted != nullptr) {
+                            return evaluate(*downcasted);
+                        }
+                    }
+                }
+            }
+            throw std::runtime_error{ "Unreachable" };
+        }
+    };
+
+} // namespace interpreter
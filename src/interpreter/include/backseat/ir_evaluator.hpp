@@ -0,0 +1,58 @@
+#pragma once
+
+#include "output_sink.hpp"
+#include <cstdint>
+#include <interpreter/error.hpp>
+#include <ir/ir.hpp>
+#include <ir/passes.hpp>
+#include <vector>
+
+namespace interpreter {
+
+    // Executes an (optionally optimized) IR program. Every value is an unboxed `u64`. Values of type `String` hold
+    // an index into `ir::Program::strings`.
+    class IrEvaluator final {
+    private:
+        std::vector<std::uint64_t> m_values;
+
+    public:
+        // The strings of `program` are borrowed by `output`, so the program must outlive its next flush.
+        auto run(ir::Program const& program, OutputSink& output) -> void {
+            // A precomputed output that exceeds the buffer of the sink is written with a single system call.
+            if (auto const blob = ir::output_blob(program); blob.has_value()) {
+                output.write(blob.value());
+                return;
+            }
+            m_values.assign(program.instructions.size(), 0);
+            for (auto i = 0uz; i < program.instructions.size(); ++i) {
+                auto const& [opcode, immediate, lhs, rhs] = program.instructions[i];
+                switch (opcode) {
+                    case ir::Opcode::Constant:
+                    case ir::Opcode::String:
+                        m_values[i] = immediate;
+                        break;
+                    case ir::Opcode::Divide:
+                    case ir::Opcode::Modulo:
+                        if (m_values[rhs] == 0) {
+                            throw InterpreterError{ "Division by zero." };
+                        }
+                        m_values[i] = ir::fold(opcode, m_values[lhs], m_values[rhs]);
+                        break;
+                    case ir::Opcode::PrintU64:
+                        output.write_u64(m_values[lhs]);
+                        break;
+                    case ir::Opcode::PrintString:
+                        output.write_borrowed(program.strings[m_values[lhs]]);
+                        break;
+                    case ir::Opcode::PrintNewline:
+                        output.write('\n');
+                        break;
+                    default:
+                        m_values[i] = ir::fold(opcode, m_values[lhs], m_values[rhs]);
+                        break;
+                }
+            }
+        }
+    };
+
+} // namespace interpreter
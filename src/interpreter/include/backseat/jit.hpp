@@ -0,0 +1,400 @@
+#pragma once
+
+#include "output_sink.hpp"
+#include "x86_64_assembler.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <experimental/meta>
+#include <interpreter/error.hpp>
+#include <memory>
+#include <span>
+#include <string>
+#include <sys/mman.h>
+#include <tl/optional.hpp>
+#include <type_checker/type_checker.hpp>
+#include <utility>
+#include <vector>
+
+namespace interpreter {
+
+    enum class JitStatus : std::uint64_t {
+        Success,
+        DivisionByZero,
+        OutputError,
+    };
+
+    // The generated code prints to the given sink.
+    using JitFunction = auto (*)(OutputSink* output) -> JitStatus;
+
+    // Read-only, executable copy of machine code.
+    class ExecutableMemory final {
+    private:
+        void* m_data{ nullptr };
+        usize m_size{ 0 };
+
+    public:
+        [[nodiscard]] ExecutableMemory() = default;
+
+        [[nodiscard]] explicit ExecutableMemory(std::span<std::uint8_t const> const code) : m_size{ code.size() } {
+            if (code.empty()) {
+                return;
+            }
+            m_data = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (m_data == MAP_FAILED) {
+                m_data = nullptr;
+                throw InterpreterError{ "Unable to allocate memory for JIT-compiled code." };
+            }
+            std::memcpy(m_data, code.data(), code.size());
+            if (mprotect(m_data, m_size, PROT_READ | PROT_EXEC) != 0) {
+                munmap(m_data, m_size);
+                m_data = nullptr;
+                throw InterpreterError{ "Unable to make JIT-compiled code executable." };
+            }
+        }
+
+        ExecutableMemory(ExecutableMemory const& other) = delete;
+
+        ExecutableMemory(ExecutableMemory&& other) noexcept
+            : m_data{ std::exchange(other.m_data, nullptr) },
+              m_size{ std::exchange(other.m_size, 0) } { }
+
+        ExecutableMemory& operator=(ExecutableMemory const& other) = delete;
+
+        ExecutableMemory& operator=(ExecutableMemory&& other) noexcept {
+            if (this != std::addressof(other)) {
+                std::swap(m_data, other.m_data);
+                std::swap(m_size, other.m_size);
+            }
+            return *this;
+        }
+
+        ~ExecutableMemory() {
+            if (m_data != nullptr) {
+                munmap(m_data, m_size);
+            }
+        }
+
+        [[nodiscard]] auto function_at(usize const offset) const -> JitFunction {
+            return std::bit_cast<JitFunction>(static_cast<std::uint8_t const*>(m_data) + offset);
+        }
+    };
+
+    // A consecutive range of top-level statements. If `function` is `nullptr`, the statements could not be
+    // compiled and have to be run by the tree-walking interpreter instead.
+    struct JitSegment final {
+        JitFunction function;
+        usize begin;
+        usize end;
+    };
+
+    class JitProgram final {
+    private:
+        ExecutableMemory m_memory;
+        std::deque<std::string> m_strings; // Referenced by address from the machine code.
+        std::vector<JitSegment> m_segments;
+
+    public:
+        [[nodiscard]] JitProgram() = default;
+
+        [[nodiscard]] JitProgram(
+                ExecutableMemory memory,
+                std::deque<std::string> strings,
+                std::vector<JitSegment> segments
+        )
+            : m_memory{ std::move(memory) },
+              m_strings{ std::move(strings) },
+              m_segments{ std::move(segments) } { }
+
+        [[nodiscard]] auto segments() const -> std::span<JitSegment const> {
+            return m_segments;
+        }
+    };
+
+    // Compiles runs of consecutive top-level statements into native x86-64 functions. Expressions are evaluated
+    // into rax, using the machine stack for intermediate results. A statement that contains anything the compiler
+    // does not support is left to the tree-walking interpreter.
+    class JitCompiler final {
+    private:
+        // The targets of the conditional jumps that leave a run early.
+        struct ErrorLabels final {
+            Label division_by_zero;
+            Label output_error;
+        };
+
+        struct Run final {
+            usize begin;
+            usize code_offset;
+            ErrorLabels errors;
+        };
+
+        X86_64Assembler m_assembler;
+        std::deque<std::string> m_strings;
+
+    public:
+        [[nodiscard]] auto compile(std::span<std::shared_ptr<type_checker::Statement const> const> const statements)
+                -> JitProgram {
+            struct PendingSegment final {
+                tl::optional<usize> code_offset;
+                usize begin;
+                usize end;
+            };
+
+            auto pending_segments = std::vector<PendingSegment>{};
+            auto current_run = tl::optional<Run>{};
+            auto const end_run = [&](usize const end) {
+                if (not current_run.has_value()) {
+                    return;
+                }
+                if (end == current_run->begin) {
+                    // Not a single statement could be compiled, so we drop the prologue again.
+                    m_assembler.truncate(current_run->code_offset);
+                } else {
+                    emit_epilogue(current_run.value());
+                    pending_segments.push_back(PendingSegment{ current_run->code_offset, current_run->begin, end });
+                }
+                current_run = tl::nullopt;
+            };
+
+            for (auto i = 0uz; i < statements.size(); ++i) {
+                if (is_supported_platform()) {
+                    if (not current_run.has_value()) {
+                        auto const errors = ErrorLabels{ m_assembler.create_label(), m_assembler.create_label() };
+                        current_run = Run{ i, m_assembler.size(), errors };
+                        emit_prologue();
+                    }
+                    auto const rollback_size = m_assembler.size();
+                    if (compile_statement(*statements[i], current_run->errors)) {
+                        continue;
+                    }
+                    m_assembler.truncate(rollback_size);
+                    end_run(i);
+                }
+                if (pending_segments.empty() or pending_segments.back().code_offset.has_value()) {
+                    pending_segments.push_back(PendingSegment{ tl::nullopt, i, i + 1 });
+                } else {
+                    pending_segments.back().end = i + 1;
+                }
+            }
+            end_run(statements.size());
+
+            auto memory = ExecutableMemory{ std::move(m_assembler).finish() };
+            auto segments = std::vector<JitSegment>{};
+            segments.reserve(pending_segments.size());
+            for (auto const& [code_offset, begin, end] : pending_segments) {
+                auto const function = code_offset.has_value() ? memory.function_at(code_offset.value()) : nullptr;
+                segments.push_back(JitSegment{ function, begin, end });
+            }
+            return JitProgram{ std::move(memory), std::move(m_strings), std::move(segments) };
+        }
+
+    private:
+        [[nodiscard]] static constexpr auto is_supported_platform() -> bool {
+#if defined(__x86_64__)
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        // Called from the generated code. An exception must not propagate into it since there is no unwind
+        // information for the generated code, so a failed write is returned as a status instead. The generated code
+        // leaves the run with that status (see `emit_checked_call()`).
+        static auto print_u64(OutputSink* const output, std::uint64_t const value) noexcept -> JitStatus {
+            return write_output([&] { output->write_u64(value); });
+        }
+
+        static auto print_string(OutputSink* const output, std::string const* const string) noexcept -> JitStatus {
+            return write_output([&] { output->write(*string); });
+        }
+
+        static auto print_newline(OutputSink* const output) noexcept -> JitStatus {
+            return write_output([&] { output->write('\n'); });
+        }
+
+        [[nodiscard]] static auto write_output(auto const& write) noexcept -> JitStatus {
+            try {
+                write();
+                return JitStatus::Success;
+            } catch (...) {
+                return JitStatus::OutputError;
+            }
+        }
+
+        auto emit_prologue() -> void {
+            // After pushing rbp, the stack is 16-byte aligned again. rbx holds the output sink (the argument of
+            // the function) for the whole function. It is callee-saved, so it is pushed twice to keep the
+            // alignment. Every statement leaves the stack balanced, so calls can be emitted without further
+            // adjustments.
+            m_assembler.push(Register::Rbp);
+            m_assembler.mov(Register::Rbp, Register::Rsp);
+            m_assembler.push(Register::Rbx);
+            m_assembler.push(Register::Rbx);
+            m_assembler.mov(Register::Rbx, Register::Rdi);
+        }
+
+        auto emit_return(JitStatus const status) -> void {
+            if (status == JitStatus::Success) {
+                m_assembler.zero(Register::Rax);
+            } else {
+                m_assembler.mov(Register::Rax, std::to_underlying(status));
+            }
+            // Restoring rsp from rbp also discards any intermediate results that are still on the stack. The
+            // saved copies of rbx are right below the saved rbp.
+            m_assembler.mov(Register::Rcx, std::uint64_t{ 16 });
+            m_assembler.mov(Register::Rsp, Register::Rbp);
+            m_assembler.sub(Register::Rsp, Register::Rcx);
+            m_assembler.pop(Register::Rbx);
+            m_assembler.pop(Register::Rbx);
+            m_assembler.pop(Register::Rbp);
+            m_assembler.ret();
+        }
+
+        auto emit_epilogue(Run const& run) -> void {
+            emit_return(JitStatus::Success);
+            m_assembler.bind(run.errors.division_by_zero);
+            emit_return(JitStatus::DivisionByZero);
+            m_assembler.bind(run.errors.output_error);
+            emit_return(JitStatus::OutputError);
+        }
+
+        // Calls one of the output helpers above and leaves the run if it reports an error.
+        auto emit_checked_call(auto const function, ErrorLabels const& errors) -> void {
+            m_assembler.mov(Register::Rax, std::bit_cast<std::uint64_t>(function));
+            m_assembler.call(Register::Rax);
+            m_assembler.test(Register::Rax, Register::Rax);
+            m_assembler.jnz(errors.output_error);
+        }
+
+        [[nodiscard]] auto compile_print_argument(type_checker::Expression const& argument, ErrorLabels const& errors)
+                -> bool {
+            if (not compile_expression(argument, errors)) {
+                return false;
+            }
+            m_assembler.mov(Register::Rsi, Register::Rax);
+            m_assembler.mov(Register::Rdi, Register::Rbx);
+            if (argument.data_type() == type_checker::string_type) {
+                emit_checked_call(&print_string, errors);
+                return true;
+            }
+            if (argument.data_type() == type_checker::u64_type) {
+                emit_checked_call(&print_u64, errors);
+                return true;
+            }
+            return false;
+        }
+
+        [[nodiscard]] auto compile(type_checker::Print const& statement, ErrorLabels const& errors) -> bool {
+            return compile_print_argument(*statement.argument(), errors);
+        }
+
+        [[nodiscard]] auto compile(type_checker::Println const& statement, ErrorLabels const& errors) -> bool {
+            if (not compile_print_argument(*statement.argument(), errors)) {
+                return false;
+            }
+            m_assembler.mov(Register::Rdi, Register::Rbx);
+            emit_checked_call(&print_newline, errors);
+            return true;
+        }
+
+        [[nodiscard]] auto compile(type_checker::StringLiteral const& expression, ErrorLabels const&) -> bool {
+            m_strings.emplace_back(expression.value());
+            m_assembler.mov(Register::Rax, std::bit_cast<std::uint64_t>(std::addressof(m_strings.back())));
+            return true;
+        }
+
+        [[nodiscard]] auto compile(type_checker::UnsignedIntegerLiteral const& expression, ErrorLabels const&)
+                -> bool {
+            m_assembler.mov(Register::Rax, expression.value());
+            return true;
+        }
+
+        [[nodiscard]] auto compile(type_checker::BinaryOperator const& expression, ErrorLabels const& errors) -> bool {
+            if (not compile_expression(expression.lhs(), errors)) {
+                return false;
+            }
+            m_assembler.push(Register::Rax);
+            if (not compile_expression(expression.rhs(), errors)) {
+                return false;
+            }
+            m_assembler.mov(Register::Rcx, Register::Rax);
+            m_assembler.pop(Register::Rax);
+
+            switch (expression.operator_type()) {
+                case lexer::TokenType::Plus:
+                    m_assembler.add(Register::Rax, Register::Rcx);
+                    return true;
+                case lexer::TokenType::Minus:
+                    m_assembler.sub(Register::Rax, Register::Rcx);
+                    return true;
+                case lexer::TokenType::Asterisk:
+                    m_assembler.imul(Register::Rax, Register::Rcx);
+                    return true;
+                case lexer::TokenType::ForwardSlash:
+                    emit_division(errors);
+                    return true;
+                case lexer::TokenType::Mod:
+                    emit_division(errors);
+                    m_assembler.mov(Register::Rax, Register::Rdx);
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        // Fallback for all node types that cannot be compiled (yet).
+        [[nodiscard]] auto compile(auto const&, ErrorLabels const&) -> bool {
+            return false;
+        }
+
+        auto emit_division(ErrorLabels const& errors) -> void {
+            m_assembler.test(Register::Rcx, Register::Rcx);
+            m_assembler.jz(errors.division_by_zero);
+            m_assembler.zero(Register::Rdx);
+            m_assembler.div(Register::Rcx);
+        }
+
+        [[nodiscard]] auto compile_statement(type_checker::Statement const& statement, ErrorLabels const& errors)
+                -> bool {
+            static constexpr auto context = std::meta::access_context::current();
+            template for (constexpr auto member : std::define_static_array(members_of(^^type_checker, context))) {
+                if constexpr (is_type(member) and is_class_type(member)) {
+                    static constexpr auto does_inherit_base =
+                            std::ranges::any_of(bases_of(member, context), [](auto const& base) {
+                                return is_same_type(type_of(base), ^^type_checker::Statement);
+                            });
+                    if constexpr (does_inherit_base) {
+                        auto const downcasted = dynamic_cast<[:member:] const*>(std::addressof(statement));
+                        if (downcasted != nullptr) {
+                            return compile(*downcasted, errors);
+                        }
+                    }
+                }
+            }
+            return false;
+        }
+
+        [[nodiscard]] auto compile_expression(type_checker::Expression const& expression, ErrorLabels const& errors)
+                -> bool {
+            static constexpr auto context = std::meta::access_context::current();
+            template for (constexpr auto member : std::define_static_array(members_of(^^type_checker, context))) {
+                if constexpr (is_type(member) and is_class_type(member)) {
+                    static constexpr auto does_inherit_base =
+                            std::ranges::any_of(bases_of(member, context), [](auto const& base) {
+                                return is_same_type(type_of(base), ^^type_checker::Expression);
+                            });
+                    if constexpr (does_inherit_base) {
+                        auto const downcasted = dynamic_cast<[:member:] const*>(std::addressof(expression));
+                        if (downcasted != nullptr) {
+                            return compile(*downcasted, errors);
+                        }
+                    }
+                }
+            }
+            return false;
+        }
+    };
+
+} // namespace interpreter
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "values.hpp"
+#include <array>
+#include <cstdint>
+#include <experimental/meta>
+#include <interpreter/error.hpp>
+#include <ranges>
+#include <type_checker/expressions.hpp>
+
+namespace interpreter {
+
+    using BinaryOperatorKernel = auto (*)(Value lhs, Value rhs) -> Value;
+
+    // Implementations of the binary operators for all operand types that `type_checker::BinaryOperator` accepts,
+    // in terms of the representations of the operand types (see `representation_of()`). Written by hand: operand
+    // types with a new representation need a new overload, otherwise `make_binary_operator_kernels()` fails to
+    // compile.
+    template<lexer::TokenType operator_token_type>
+    [[nodiscard]] auto apply_binary_operator(std::uint64_t const lhs, std::uint64_t const rhs) -> Value {
+        if constexpr (operator_token_type == lexer::TokenType::Plus) {
+            return Value::u64(lhs + rhs);
+        } else if constexpr (operator_token_type == lexer::TokenType::Minus) {
+            return Value::u64(lhs - rhs);
+        } else if constexpr (operator_token_type == lexer::TokenType::Asterisk) {
+            return Value::u64(lhs * rhs);
+        } else if constexpr (operator_token_type == lexer::TokenType::ForwardSlash) {
+            if (rhs == 0) {
+                throw InterpreterError{ "Division by zero." };
+            }
+            return Value::u64(lhs / rhs);
+        } else if constexpr (operator_token_type == lexer::TokenType::Mod) {
+            if (rhs == 0) {
+                throw InterpreterError{ "Division by zero." };
+            }
+            return Value::u64(lhs % rhs);
+        } else {
+            static_assert(false, "Unsupported binary operator.");
+        }
+    }
+
+    // The type checker guarantees the operand types, so their representations are read without checking the tags.
+    template<
+            lexer::TokenType operator_token_type,
+            type_checker::BuiltinDataType lhs_type,
+            type_checker::BuiltinDataType rhs_type>
+    [[nodiscard]] auto binary_operator_kernel(Value const lhs, Value const rhs) -> Value {
+        return apply_binary_operator<operator_token_type>(lhs.get<lhs_type>(), rhs.get<rhs_type>());
+    }
+
+    // Indexed by `type_checker::KernelId`. Contains a specialized kernel for every combination of operator and
+    // operand types that passes type checking (and `nullptr` for all others). The table and the dispatch follow new
+    // builtin data types automatically, the operations themselves come from `apply_binary_operator()`.
+    [[nodiscard]] consteval auto make_binary_operator_kernels() {
+        using type_checker::BinaryOperator;
+        static constexpr auto num_data_types = usize{ type_checker::num_builtin_data_types };
+        static constexpr auto kernel_ids =
+                std::define_static_array(std::views::iota(type_checker::KernelId{ 0 }, BinaryOperator::num_kernels));
+
+        auto kernels = std::array<BinaryOperatorKernel, BinaryOperator::num_kernels>{};
+        template for (constexpr auto kernel : kernel_ids) {
+            if constexpr (BinaryOperator::get_resulting_data_type(kernel).has_value()) {
+                static constexpr auto operator_token_type =
+                        BinaryOperator::operator_token_types[kernel / (num_data_types * num_data_types)];
+                static constexpr auto lhs_type =
+                        static_cast<type_checker::BuiltinDataType>((kernel / num_data_types) % num_data_types);
+                static constexpr auto rhs_type = static_cast<type_checker::BuiltinDataType>(kernel % num_data_types);
+                kernels[kernel] = &binary_operator_kernel<operator_token_type, lhs_type, rhs_type>;
+            }
+        }
+        return kernels;
+    }
+
+    inline constexpr auto binary_operator_kernels = make_binary_operator_kernels();
+
+} // namespace interpreter
@@ -0,0 +1,246 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <utility>
+#include <utils/types.hpp>
+#include <vector>
+
+namespace interpreter {
+
+    // Collects the output of a program in a large user-space buffer and hands it to the operating system in as
+    // few system calls as possible: the buffer is only flushed when it is full or on request. Writes that don't
+    // fit into the buffer are combined with the buffered data into a single `writev`.
+    //
+    // Text that stays valid until the next flush (e.g. interned string literals) can be borrowed instead of copied:
+    // the sink keeps a list of iovecs that alternate between runs of the buffer and borrowed slices, and writes all
+    // of them at once when it is flushed.
+    //
+    // A sink that writes to memory appends to the target string directly, since the string is a buffer itself. The
+    // buffer of a sink that writes to a file descriptor is allocated on the first write, so unused sinks are cheap.
+    class OutputSink final {
+    private:
+        static constexpr auto default_capacity = usize{ 64 } * 1024;
+        // Shorter slices are cheaper to copy than to pass as separate iovecs.
+        static constexpr auto min_borrowed_size = 128uz;
+        // `IOV_MAX` on Linux.
+        static constexpr auto max_num_vectors = 1024uz;
+
+        std::unique_ptr<char[]> m_buffer;
+        usize m_capacity{ 0 };
+        usize m_size{ 0 };
+        // The buffered bytes before this offset are already referenced by `m_vectors`.
+        usize m_run_start{ 0 };
+        std::vector<iovec> m_vectors;
+        int m_file_descriptor{ -1 };
+        std::string* m_memory{ nullptr };
+        // Negative values wait forever.
+        std::chrono::milliseconds m_write_timeout{ -1 };
+
+        [[nodiscard]] OutputSink() = default;
+
+    public:
+        [[nodiscard]] static auto to_file_descriptor(int const file_descriptor, usize const capacity = default_capacity)
+                -> OutputSink {
+            auto sink = OutputSink{};
+            sink.m_capacity = capacity;
+            sink.m_file_descriptor = file_descriptor;
+            return sink;
+        }
+
+        [[nodiscard]] static auto to_stdout(usize const capacity = default_capacity) -> OutputSink {
+            return to_file_descriptor(STDOUT_FILENO, capacity);
+        }
+
+        // The target must outlive the sink.
+        [[nodiscard]] static auto to_memory(std::string& target) -> OutputSink {
+            auto sink = OutputSink{};
+            sink.m_memory = std::addressof(target);
+            return sink;
+        }
+
+        OutputSink(OutputSink const& other) = delete;
+
+        OutputSink(OutputSink&& other) noexcept
+            : m_buffer{ std::move(other.m_buffer) },
+              m_capacity{ std::exchange(other.m_capacity, 0) },
+              m_size{ std::exchange(other.m_size, 0) },
+              m_run_start{ std::exchange(other.m_run_start, 0) },
+              m_vectors{ std::exchange(other.m_vectors, {}) },
+              m_file_descriptor{ std::exchange(other.m_file_descriptor, -1) },
+              m_memory{ std::exchange(other.m_memory, nullptr) },
+              m_write_timeout{ other.m_write_timeout } { }
+
+        OutputSink& operator=(OutputSink const& other) = delete;
+
+        OutputSink& operator=(OutputSink&& other) noexcept {
+            if (this != std::addressof(other)) {
+                flush_or_discard();
+                m_buffer = std::move(other.m_buffer);
+                m_capacity = std::exchange(other.m_capacity, 0);
+                m_size = std::exchange(other.m_size, 0);
+                m_run_start = std::exchange(other.m_run_start, 0);
+                m_vectors = std::exchange(other.m_vectors, {});
+                m_file_descriptor = std::exchange(other.m_file_descriptor, -1);
+                m_memory = std::exchange(other.m_memory, nullptr);
+                m_write_timeout = other.m_write_timeout;
+            }
+            return *this;
+        }
+
+        // Destroying a sink flushes it. Errors can't be reported from here, so call `flush()` to detect them.
+        ~OutputSink() {
+            flush_or_discard();
+        }
+
+        // A write to a non-blocking file descriptor waits at most `timeout` for the descriptor to accept more data
+        // and fails with an `InterpreterError` after that. This way a reader that stops reading can't block the
+        // writer forever.
+        auto set_write_timeout(std::chrono::milliseconds const timeout) -> void {
+            m_write_timeout = timeout;
+        }
+
+        auto write(std::string_view const text) -> void {
+            if (m_memory != nullptr) {
+                m_memory->append(text);
+                return;
+            }
+            if (m_buffer == nullptr) [[unlikely]] {
+                allocate_buffer();
+            }
+            if (text.size() <= m_capacity - m_size) {
+                std::memcpy(m_buffer.get() + m_size, text.data(), text.size());
+                m_size += text.size();
+                return;
+            }
+            if (text.size() < m_capacity) {
+                flush();
+                std::memcpy(m_buffer.get(), text.data(), text.size());
+                m_size = text.size();
+                return;
+            }
+            write_through(text);
+        }
+
+        // Like `write()`, but `text` is not copied if it is long enough. It must stay valid until the next flush.
+        auto write_borrowed(std::string_view const text) -> void {
+            if (m_memory != nullptr or text.size() < min_borrowed_size) {
+                write(text);
+                return;
+            }
+            if (m_buffer == nullptr) [[unlikely]] {
+                allocate_buffer();
+            }
+            end_run();
+            m_vectors.push_back(iovec{ const_cast<char*>(text.data()), text.size() });
+            if (m_vectors.size() >= max_num_vectors - 1) {
+                flush();
+            }
+        }
+
+        auto write(char const c) -> void {
+            if (m_memory != nullptr) {
+                m_memory->push_back(c);
+                return;
+            }
+            if (m_buffer == nullptr) [[unlikely]] {
+                allocate_buffer();
+            }
+            if (m_size == m_capacity) {
+                flush();
+            }
+            m_buffer[m_size++] = c;
+        }
+
+        auto write_u64(std::uint64_t const value) -> void {
+            auto digits = std::array<char, max_num_u64_digits>{};
+            write(format_u64(value, digits));
+        }
+
+        auto flush() -> void {
+            end_run();
+            if (m_vectors.empty()) {
+                return;
+            }
+            // Data that has been printed through stdio before must not be overtaken.
+            if (m_file_descriptor == STDOUT_FILENO) {
+                std::fflush(stdout);
+            }
+            write_all(m_vectors);
+            m_vectors.clear();
+            m_size = 0;
+            m_run_start = 0;
+        }
+
+        static constexpr auto max_num_u64_digits = 20uz;
+
+        // Formats `value` into the end of `digits`, two digits at a time with a lookup table.
+        [[nodiscard]] static auto format_u64(std::uint64_t value, std::array<char, max_num_u64_digits>& digits)
+                -> std::string_view {
+            static constexpr auto digit_pairs = [] {
+                auto pairs = std::array<char, 200>{};
+                for (auto i = 0uz; i < 100; ++i) {
+                    pairs[2 * i] = static_cast<char>('0' + i / 10);
+                    pairs[2 * i + 1] = static_cast<char>('0' + i % 10);
+                }
+                return pairs;
+            }();
+
+            auto position = digits.size();
+            while (value >= 100) {
+                auto const pair = static_cast<usize>(value % 100) * 2;
+                value /= 100;
+                digits[--position] = digit_pairs[pair + 1];
+                digits[--position] = digit_pairs[pair];
+            }
+            if (value >= 10) {
+                auto const pair = static_cast<usize>(value) * 2;
+                digits[--position] = digit_pairs[pair + 1];
+                digits[--position] = digit_pairs[pair];
+            } else {
+                digits[--position] = static_cast<char>('0' + value);
+            }
+            return std::string_view{ digits.data() + position, digits.size() - position };
+        }
+
+    private:
+        auto allocate_buffer() -> void {
+            m_buffer = std::make_unique_for_overwrite<char[]>(m_capacity);
+            m_vectors.reserve(max_num_vectors);
+        }
+
+        // Writes the pending data followed by `text` without copying `text` into the buffer.
+        auto write_through(std::string_view const text) -> void {
+            end_run();
+            m_vectors.push_back(iovec{ const_cast<char*>(text.data()), text.size() });
+            flush();
+        }
+
+        // Makes the buffered bytes that are not referenced yet the next iovec.
+        auto end_run() -> void {
+            if (m_size > m_run_start) {
+                m_vectors.push_back(iovec{ m_buffer.get() + m_run_start, m_size - m_run_start });
+                m_run_start = m_size;
+            }
+        }
+
+        // Defined in `output_sink.cpp` like everything else that throws, so that this header can be included by
+        // hosts that are built without exceptions (see `backseat.hpp`).
+        auto write_all(std::span<iovec> vectors) const -> void;
+
+        auto wait_until_writable() const -> void;
+
+        auto flush_or_discard() noexcept -> void;
+    };
+
+} // namespace interpreter
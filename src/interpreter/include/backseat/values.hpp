@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <experimental/meta>
+#include <interpreter/error.hpp>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <type_checker/data_type.hpp>
+#include <type_traits>
+
+namespace interpreter {
+
+    // The C++ type that represents values of a builtin data type inside a `Value`. Must be extended for every new
+    // builtin data type (see `type_checker::BuiltinDataType`).
+    [[nodiscard]] consteval auto representation_of(type_checker::BuiltinDataType const data_type) -> std::meta::info {
+        switch (data_type) {
+            case type_checker::BuiltinDataType::String:
+                return ^^std::string_view;
+            case type_checker::BuiltinDataType::U64:
+                return ^^std::uint64_t;
+        }
+        throw std::logic_error{ "Missing representation for builtin data type." };
+    }
+
+    // A 16-byte value that is tagged with its data type. `U64` values are stored inline, strings refer to the
+    // decoded literals of the running program (see `type_checker::StringLiteral::value()`), so creating and
+    // copying values never allocates.
+    class Value final {
+    private:
+        union {
+            std::uint64_t m_u64;
+            char const* m_string_data;
+        };
+        std::uint32_t m_string_length{ 0 };
+        type_checker::BuiltinDataType m_data_type;
+
+        [[nodiscard]] explicit Value(type_checker::BuiltinDataType const data_type)
+            : m_u64{ 0 },
+              m_data_type{ data_type } { }
+
+    public:
+        [[nodiscard]] static auto u64(std::uint64_t const value) -> Value {
+            auto result = Value{ type_checker::BuiltinDataType::U64 };
+            result.m_u64 = value;
+            return result;
+        }
+
+        // The characters must outlive the value.
+        [[nodiscard]] static auto string(std::string_view const value) -> Value {
+            if (value.length() > std::numeric_limits<std::uint32_t>::max()) {
+                throw InterpreterError{ "String is too long." };
+            }
+            auto result = Value{ type_checker::BuiltinDataType::String };
+            result.m_string_data = value.data();
+            result.m_string_length = static_cast<std::uint32_t>(value.length());
+            return result;
+        }
+
+        [[nodiscard]] auto data_type() const -> type_checker::BuiltinDataType {
+            return m_data_type;
+        }
+
+        // The data type must match, which the type checker guarantees. Dispatches on the representation, so that
+        // only data types with a new representation need a new branch.
+        template<type_checker::BuiltinDataType data_type>
+        [[nodiscard]] auto get() const -> typename [:representation_of(data_type):] {
+            using Representation = typename [:representation_of(data_type):];
+            if constexpr (std::is_same_v<Representation, std::uint64_t>) {
+                return m_u64;
+            } else if constexpr (std::is_same_v<Representation, std::string_view>) {
+                return std::string_view{ m_string_data, m_string_length };
+            } else {
+                static_assert(false, "`Value` has no storage for this representation.");
+            }
+        }
+    };
+
+    static_assert(sizeof(Value) == 16);
+
+} // namespace interpreter
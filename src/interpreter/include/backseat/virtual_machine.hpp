@@ -0,0 +1,112 @@
+#pragma once
+
+#include "bytecode.hpp"
+#include "output_sink.hpp"
+#include <array>
+#include <cstdint>
+#include <interpreter/error.hpp>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace interpreter {
+
+    class VirtualMachine final {
+    private:
+        std::vector<std::uint64_t> m_registers;
+
+    public:
+        // The strings of `program` are borrowed by `output`, so the program must outlive its next flush.
+        auto run(BytecodeProgram const& program, OutputSink& output) -> void {
+            m_registers.assign(program.num_registers, 0);
+
+// Labels as values (computed goto) are a GNU extension, but they give us one indirect jump per instruction
+// instead of a shared, hard-to-predict jump at the top of a `switch`.
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wgnu-label-as-value"
+            // Must list the labels in the order of the `Opcode` enumerators.
+            static auto const dispatch_table = std::array{
+                &&load_constant,
+                &&load_string,
+                &&add,
+                &&subtract,
+                &&multiply,
+                &&divide,
+                &&modulo,
+                &&print_u64,
+                &&print_string,
+                &&print_newline,
+                &&halt,
+            };
+            static_assert(std::tuple_size_v<std::remove_cvref_t<decltype(dispatch_table)>> == num_opcodes);
+
+            auto const* instruction = program.instructions.data();
+            auto* const registers = m_registers.data();
+            auto const* const constants = program.constants.data();
+
+            goto* dispatch_table[std::to_underlying(instruction->opcode)];
+
+        load_constant:
+            registers[instruction->a] = constants[instruction->b];
+            ++instruction;
+            goto* dispatch_table[std::to_underlying(instruction->opcode)];
+
+        load_string:
+            registers[instruction->a] = instruction->b;
+            ++instruction;
+            goto* dispatch_table[std::to_underlying(instruction->opcode)];
+
+        add:
+            registers[instruction->a] = registers[instruction->b] + registers[instruction->c];
+            ++instruction;
+            goto* dispatch_table[std::to_underlying(instruction->opcode)];
+
+        subtract:
+            registers[instruction->a] = registers[instruction->b] - registers[instruction->c];
+            ++instruction;
+            goto* dispatch_table[std::to_underlying(instruction->opcode)];
+
+        multiply:
+            registers[instruction->a] = registers[instruction->b] * registers[instruction->c];
+            ++instruction;
+            goto* dispatch_table[std::to_underlying(instruction->opcode)];
+
+        divide:
+            if (registers[instruction->c] == 0) {
+                throw InterpreterError{ "Division by zero." };
+            }
+            registers[instruction->a] = registers[instruction->b] / registers[instruction->c];
+            ++instruction;
+            goto* dispatch_table[std::to_underlying(instruction->opcode)];
+
+        modulo:
+            if (registers[instruction->c] == 0) {
+                throw InterpreterError{ "Division by zero." };
+            }
+            registers[instruction->a] = registers[instruction->b] % registers[instruction->c];
+            ++instruction;
+            goto* dispatch_table[std::to_underlying(instruction->opcode)];
+
+        print_u64:
+            output.write_u64(registers[instruction->a]);
+            ++instruction;
+            goto* dispatch_table[std::to_underlying(instruction->opcode)];
+
+        print_string:
+            output.write_borrowed(program.strings[registers[instruction->a]]);
+            ++instruction;
+            goto* dispatch_table[std::to_underlying(instruction->opcode)];
+
+        print_newline:
+            output.write('\n');
+            ++instruction;
+            goto* dispatch_table[std::to_underlying(instruction->opcode)];
+
+        halt:
+            return;
+#pragma clang diagnostic pop
+        }
+    };
+
+} // namespace interpreter
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <utils/types.hpp>
+#include <vector>
+
+namespace interpreter {
+
+    // Only the eight legacy general purpose registers are supported, so no instruction needs REX.R or REX.B.
+    enum class Register : std::uint8_t {
+        Rax,
+        Rcx,
+        Rdx,
+        Rbx,
+        Rsp,
+        Rbp,
+        Rsi,
+        Rdi,
+    };
+
+    class Label final {
+    private:
+        usize m_index;
+
+    public:
+        [[nodiscard]] explicit Label(usize const index) : m_index{ index } { }
+
+        [[nodiscard]] auto index() const -> usize {
+            return m_index;
+        }
+    };
+
+    // Minimal encoder for the x86-64 instructions that the JIT compiler emits. All instructions operate on 64-bit
+    // registers unless stated otherwise.
+    class X86_64Assembler final {
+    private:
+        struct Fixup final {
+            usize offset; // Offset of the 32-bit displacement to patch.
+            usize label_index;
+        };
+
+        static constexpr auto rex_w = std::uint8_t{ 0x48 };
+        static constexpr auto unbound = static_cast<usize>(-1);
+
+        std::vector<std::uint8_t> m_code;
+        std::vector<usize> m_label_offsets;
+        std::vector<Fixup> m_fixups;
+
+    public:
+        [[nodiscard]] auto size() const -> usize {
+            return m_code.size();
+        }
+
+        // Discards all code emitted after `size`. Used to roll back a partially compiled statement.
+        auto truncate(usize const size) -> void {
+            m_code.resize(size);
+            std::erase_if(m_fixups, [size](Fixup const& fixup) { return fixup.offset >= size; });
+            for (auto& offset : m_label_offsets) {
+                if (offset != unbound and offset > size) {
+                    offset = unbound;
+                }
+            }
+        }
+
+        [[nodiscard]] auto create_label() -> Label {
+            m_label_offsets.push_back(unbound);
+            return Label{ m_label_offsets.size() - 1 };
+        }
+
+        auto bind(Label const label) -> void {
+            m_label_offsets.at(label.index()) = m_code.size();
+        }
+
+        // Resolves all jumps and returns the machine code.
+        [[nodiscard]] auto finish() && -> std::vector<std::uint8_t> {
+            for (auto const& [offset, label_index] : m_fixups) {
+                auto const target = m_label_offsets.at(label_index);
+                if (target == unbound) {
+                    throw std::logic_error{ "Jump to unbound label." };
+                }
+                // The displacement is relative to the end of the jump instruction.
+                auto const end_of_instruction = static_cast<std::int64_t>(offset + 4);
+                auto const displacement =
+                        static_cast<std::int32_t>(static_cast<std::int64_t>(target) - end_of_instruction);
+                auto const bytes = std::bit_cast<std::uint32_t>(displacement);
+                for (auto i = 0uz; i < 4; ++i) {
+                    m_code.at(offset + i) = static_cast<std::uint8_t>(bytes >> (8 * i));
+                }
+            }
+            return std::move(m_code);
+        }
+
+        auto push(Register const reg) -> void {
+            emit(static_cast<std::uint8_t>(0x50 + encoding(reg)));
+        }
+
+        auto pop(Register const reg) -> void {
+            emit(static_cast<std::uint8_t>(0x58 + encoding(reg)));
+        }
+
+        // mov dst, src
+        auto mov(Register const destination, Register const source) -> void {
+            emit(rex_w, 0x89, modrm(source, destination));
+        }
+
+        // mov dst, imm64
+        auto mov(Register const destination, std::uint64_t const immediate) -> void {
+            emit(rex_w, static_cast<std::uint8_t>(0xB8 + encoding(destination)));
+            for (auto i = 0uz; i < 8; ++i) {
+                emit(static_cast<std::uint8_t>(immediate >> (8 * i)));
+            }
+        }
+
+        // add dst, src
+        auto add(Register const destination, Register const source) -> void {
+            emit(rex_w, 0x01, modrm(source, destination));
+        }
+
+        // sub dst, src
+        auto sub(Register const destination, Register const source) -> void {
+            emit(rex_w, 0x29, modrm(source, destination));
+        }
+
+        // imul dst, src
+        auto imul(Register const destination, Register const source) -> void {
+            emit(rex_w, 0x0F, 0xAF, modrm(destination, source));
+        }
+
+        // test lhs, rhs
+        auto test(Register const lhs, Register const rhs) -> void {
+            emit(rex_w, 0x85, modrm(rhs, lhs));
+        }
+
+        // xor dst32, dst32 (which also clears the upper half of the 64-bit register)
+        auto zero(Register const destination) -> void {
+            emit(0x31, modrm(destination, destination));
+        }
+
+        // Unsigned division of rdx:rax by `divisor`. The quotient is stored in rax, the remainder in rdx.
+        auto div(Register const divisor) -> void {
+            emit(rex_w, 0xF7, static_cast<std::uint8_t>(0xF0 | encoding(divisor)));
+        }
+
+        // call reg
+        auto call(Register const target) -> void {
+            emit(0xFF, static_cast<std::uint8_t>(0xD0 | encoding(target)));
+        }
+
+        // jz label (with a 32-bit displacement)
+        auto jz(Label const label) -> void {
+            emit(0x0F, 0x84);
+            m_fixups.push_back(Fixup{ m_code.size(), label.index() });
+            emit(0x00, 0x00, 0x00, 0x00);
+        }
+
+        // jnz label (with a 32-bit displacement)
+        auto jnz(Label const label) -> void {
+            emit(0x0F, 0x85);
+            m_fixups.push_back(Fixup{ m_code.size(), label.index() });
+            emit(0x00, 0x00, 0x00, 0x00);
+        }
+
+        auto ret() -> void {
+            emit(0xC3);
+        }
+
+    private:
+        [[nodiscard]] static constexpr auto encoding(Register const reg) -> std::uint8_t {
+            return std::to_underlying(reg);
+        }
+
+        // ModR/M byte for a register-to-register operation.
+        [[nodiscard]] static constexpr auto modrm(Register const reg, Register const rm) -> std::uint8_t {
+            return static_cast<std::uint8_t>(0xC0 | (encoding(reg) << 3) | encoding(rm));
+        }
+
+        auto emit(std::integral auto const... bytes) -> void {
+            (m_code.push_back(static_cast<std::uint8_t>(bytes)), ...);
+        }
+    };
+
+} // namespace interpreter
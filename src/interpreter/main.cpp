@@ -1,21 +1,340 @@
 #include <type_checker/type_checker.hpp>
 #include <utils/files.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
 #include <filesystem>
+#include <format>
+#include <ir/lowering.hpp>
+#include <ir/passes.hpp>
+#include <iterator>
+#include <memory>
 #include <lexer/lexer.hpp>
 #include <parser/parser.hpp>
-#include "interpreter.hpp"
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <transpiler/transpiler.hpp>
+#include "compile_server.hpp"
+#include <backseat/batch.hpp>
+#include <backseat/interpreter.hpp>
 #include <utils/pretty_printer.hpp>
 
-int main() {
-    try {
-        static constexpr auto path = std::string_view{ "source.bs" };
-        auto const contents = utils::read_file(path);
-        auto const tokens = lexer::tokenize(path, contents.value());
+namespace {
+    struct Options final {
+        // With `--side-table`, the types are stored in a side table instead of building a typed tree.
+        bool use_side_table;
+        bool use_parallel_checking;
+        bool use_parallel_evaluation;
+        bool emit_cpp;
+        bool dump_ir;
+        // The target of `--dump-ast`, or `nullptr` if the tree is not printed.
+        FILE* ast_dump;
+        interpreter::Engine engine;
+        ir::OptimizationLevel optimization_level;
+    };
+
+    // `-` reads the script from stdin.
+    [[nodiscard]] auto read_script(std::string_view const path) -> std::string {
+        if (path == "-") {
+            return utils::read_stdin();
+        }
+        auto contents = utils::read_file(path);
+        if (not contents.has_value()) {
+            throw std::runtime_error{ std::format("Unable to read file '{}'.", path) };
+        }
+        return std::move(contents).value();
+    }
+
+    auto run_script(std::string_view const path, Options const& options) -> void {
+        auto const contents = read_script(path);
+        auto const filename = (path == "-" ? std::string_view{ "<stdin>" } : path);
+        auto const tokens = lexer::tokenize(filename, contents);
         auto parse_tree = parser::parse(tokens);
-        auto ast = type_checker::check_types(std::move(parse_tree));
-        pretty_print(ast);
-        auto interpreter = interpreter::Interpreter{ std::move(ast) };
-        interpreter.run();
+        if (options.use_side_table) {
+            auto annotations = type_checker::annotate_types(parse_tree);
+            if (options.ast_dump != nullptr) {
+                pretty_print(options.ast_dump, parse_tree);
+            }
+            auto interpreter = interpreter::Interpreter{ std::move(parse_tree), std::move(annotations) };
+            interpreter.run();
+            return;
+        }
+        auto ast = [&] {
+            if (options.use_parallel_checking) {
+                auto pool = utils::WorkStealingPool{};
+                return type_checker::check_types(std::move(parse_tree), pool);
+            }
+            return type_checker::check_types(std::move(parse_tree));
+        }();
+        if (options.emit_cpp) {
+            // Writes a standalone C++ program instead of running the script.
+            std::print("{}", transpiler::transpile(ast));
+            return;
+        }
+        if (options.dump_ir) {
+            auto const program = std::vector<std::shared_ptr<type_checker::Statement const>>(
+                    std::make_move_iterator(ast.begin()),
+                    std::make_move_iterator(ast.end())
+            );
+            std::print("{}", ir::to_string(ir::optimize(ir::lower(program), options.optimization_level)));
+            return;
+        }
+        if (options.ast_dump != nullptr) {
+            pretty_print(options.ast_dump, ast);
+        }
+        auto interpreter = interpreter::Interpreter{ std::move(ast), options.engine, options.optimization_level };
+        if (options.use_parallel_evaluation) {
+            auto pool = utils::WorkStealingPool{};
+            interpreter.run(pool);
+        } else {
+            interpreter.run();
+        }
+    }
+} // namespace
+
+// Usage: interpreter [options] [file...]
+//
+// Every argument that doesn't start with `--` is a script to run, `-` stands for stdin. Without arguments,
+// `source.bs` is run. Multiple scripts are run one after another in the same process (batch mode), so the startup
+// cost is only paid once. A failing script doesn't stop the batch, but makes the exit code non-zero.
+//
+// `--serve=<socket>` starts a compile server for `interpreter_client` instead, `--zygote=<socket>` starts one that
+// runs every script in a forked process (see `compile_server.hpp`). With `--parallel-batch`, the scripts of a batch
+// are compiled and run concurrently on all cores, their outputs are still printed in order. `--emit-cpp` and
+// `--watch` accept a single file. Unknown options are rejected.
+int main(int const argc, char const* const* const argv) {
+    try {
+        auto const arguments = std::span{ argv, static_cast<usize>(argc) };
+        // Misspelled options must not be mistaken for files or silently ignored.
+        static constexpr auto known_flags = std::array<std::string_view, 8>{
+            "--side-table", "--parallel-check", "--parallel-run",   "--emit-cpp",
+            "--dump-ir",    "--dump-ast",       "--parallel-batch", "--watch",
+        };
+        static constexpr auto known_prefixes = std::array<std::string_view, 5>{
+            "--engine=", "--opt-level=", "--dump-ast=", "--serve=", "--zygote=",
+        };
+        for (auto const argument : arguments.subspan(1)) {
+            auto const view = std::string_view{ argument };
+            if (
+                view.starts_with("--") and std::ranges::find(known_flags, view) == known_flags.end()
+                and std::ranges::none_of(known_prefixes, [view](auto const prefix) { return view.starts_with(prefix); })
+            ) {
+                throw std::invalid_argument{ std::format("Unknown option '{}'.", view) };
+            }
+        }
+        auto const has_flag = [&](std::string_view const flag) {
+            return std::ranges::any_of(arguments, [flag](char const* const argument) {
+                return std::string_view{ argument } == flag;
+            });
+        };
+        auto const option_value = [&](std::string_view const prefix) -> std::optional<std::string_view> {
+            for (auto const argument : arguments) {
+                auto const view = std::string_view{ argument };
+                if (view.starts_with(prefix)) {
+                    return view.substr(prefix.length());
+                }
+            }
+            return std::nullopt;
+        };
+        auto const engine = [&] {
+            auto const name = option_value("--engine=").value_or("tree");
+            if (name == "tree") {
+                return interpreter::Engine::Tree;
+            }
+            if (name == "bytecode") {
+                return interpreter::Engine::Bytecode;
+            }
+            if (name == "jit") {
+                return interpreter::Engine::Jit;
+            }
+            if (name == "closures") {
+                return interpreter::Engine::Closures;
+            }
+            if (name == "ir") {
+                return interpreter::Engine::Ir;
+            }
+            throw std::invalid_argument{
+                std::format("Unknown engine '{}' (expected 'tree', 'bytecode', 'jit', 'closures' or 'ir').", name)
+            };
+        }();
+        auto const optimization_level = [&] {
+            auto const level = option_value("--opt-level=").value_or("2");
+            static constexpr auto levels = std::array{
+                std::pair{ "0", ir::OptimizationLevel::O0 },
+                std::pair{ "1", ir::OptimizationLevel::O1 },
+                std::pair{ "2", ir::OptimizationLevel::O2 },
+                std::pair{ "3", ir::OptimizationLevel::O3 },
+            };
+            auto const it = std::ranges::find_if(levels, [level](auto const& pair) { return pair.first == level; });
+            if (it == levels.end()) {
+                throw std::invalid_argument{ std::format("Unknown optimization level '{}' (expected 0 to 3).", level) };
+            }
+            return it->second;
+        }();
+
+        // The reflective pretty printer is slow on large programs, so the tree is only printed on request.
+        // `--dump-ast` prints it to stdout, `--dump-ast=<file>` writes it to a file.
+        auto ast_dump_file = std::unique_ptr<FILE, decltype(&std::fclose)>{ nullptr, &std::fclose };
+        if (auto const ast_dump_path = option_value("--dump-ast="); ast_dump_path.has_value()) {
+            ast_dump_file.reset(std::fopen(std::string{ *ast_dump_path }.c_str(), "w"));
+            if (ast_dump_file == nullptr) {
+                throw std::runtime_error{ std::format("Unable to open file '{}'.", *ast_dump_path) };
+            }
+        }
+        auto const ast_dump = [&]() -> FILE* {
+            if (ast_dump_file != nullptr) {
+                return ast_dump_file.get();
+            }
+            return has_flag("--dump-ast") ? stdout : nullptr;
+        }();
+        auto const options = Options{
+            .use_side_table = has_flag("--side-table"),
+            .use_parallel_checking = has_flag("--parallel-check"),
+            .use_parallel_evaluation = has_flag("--parallel-run"),
+            .emit_cpp = has_flag("--emit-cpp"),
+            .dump_ir = has_flag("--dump-ir"),
+            .ast_dump = ast_dump,
+            .engine = engine,
+            .optimization_level = optimization_level,
+        };
+
+        auto paths = std::vector<std::string_view>{};
+        for (auto const argument : arguments.subspan(1)) {
+            auto const view = std::string_view{ argument };
+            if (not view.starts_with("--")) {
+                paths.push_back(view);
+            }
+        }
+        // These modes produce a single result (one C++ translation unit or the reruns of one script), so they only
+        // accept a single file.
+        if (paths.size() > 1 and options.emit_cpp) {
+            throw std::invalid_argument{ "--emit-cpp accepts only one file." };
+        }
+        if (paths.size() > 1 and has_flag("--watch")) {
+            throw std::invalid_argument{ "--watch accepts only one file." };
+        }
+
+        auto const serve_path = option_value("--serve=");
+        auto const zygote_path = option_value("--zygote=");
+        if (serve_path.has_value() or zygote_path.has_value()) {
+            // Runs the scripts of `interpreter_client` until the process is killed. The given files are compiled
+            // up front.
+            auto server = interpreter::CompileServer{
+                std::string{ serve_path.has_value() ? *serve_path : *zygote_path },
+                engine,
+                optimization_level,
+                serve_path.has_value() ? interpreter::ServerIsolation::InProcess
+                                       : interpreter::ServerIsolation::ForkPerScript,
+            };
+            for (auto const path : paths) {
+                server.preload(path);
+            }
+            server.serve();
+        }
+
+        if (paths.empty()) {
+            paths.emplace_back("source.bs");
+        }
+
+        if (has_flag("--watch")) {
+            // Reruns the script whenever it changes. Unchanged statements are taken from the compilation cache.
+            auto const path = paths.front();
+            if (path == "-") {
+                throw std::invalid_argument{ "Cannot watch stdin." };
+            }
+            auto cache = type_checker::CompilationCache{};
+            auto previous_contents = std::optional<std::string>{};
+            while (true) {
+                auto contents = utils::read_file(path);
+                if (contents.has_value() and contents != previous_contents) {
+                    previous_contents = contents;
+                    try {
+                        auto program = cache.compile(path, contents.value());
+                        std::println(
+                                stderr,
+                                "Reused {} of {} statements.",
+                                cache.num_reused_statements(),
+                                program.size()
+                        );
+                        auto interpreter = interpreter::Interpreter{ std::move(program), engine, optimization_level };
+                        interpreter.run();
+                    } catch (std::exception const& e) {
+                        std::println("{}", e.what());
+                    }
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds{ 200 });
+            }
+        }
+
+        if (has_flag("--parallel-batch")) {
+            // Compiles and runs the scripts concurrently. Only the engine and the optimization level apply here.
+            // A script that can't be read fails on its own, just like when running the scripts one after another.
+            auto results = std::vector<backseat::BatchResult>(paths.size());
+            auto sources = std::vector<std::optional<std::string>>(paths.size());
+            for (auto i = 0uz; i < paths.size(); ++i) {
+                try {
+                    sources.at(i) = read_script(paths.at(i));
+                } catch (std::exception const& e) {
+                    results.at(i).diagnostics.report(utils::DiagnosticKind::RuntimeError, e.what());
+                }
+            }
+            auto scripts = std::vector<backseat::BatchScript>{};
+            scripts.reserve(paths.size());
+            for (auto i = 0uz; i < paths.size(); ++i) {
+                if (sources.at(i).has_value()) {
+                    auto const filename = (paths.at(i) == "-" ? std::string_view{ "<stdin>" } : paths.at(i));
+                    scripts.push_back(backseat::BatchScript{ filename, *sources.at(i) });
+                }
+            }
+            auto executor = backseat::BatchExecutor{
+                backseat::CompileOptions{ .engine = engine, .optimization_level = optimization_level },
+            };
+            auto script_results = executor.run(scripts);
+            auto next_result = script_results.begin();
+            for (auto i = 0uz; i < paths.size(); ++i) {
+                if (sources.at(i).has_value()) {
+                    results.at(i) = std::move(*next_result++);
+                }
+            }
+            auto output = interpreter::OutputSink::to_stdout();
+            auto num_failures = 0uz;
+            for (auto const& result : results) {
+                output.write_borrowed(result.output);
+                for (auto const& diagnostic : result.diagnostics.entries()) {
+                    output.write(diagnostic.message);
+                    output.write('\n');
+                }
+                if (not result.succeeded()) {
+                    ++num_failures;
+                }
+            }
+            output.flush();
+            if (paths.size() > 1 and num_failures > 0) {
+                std::println(stderr, "{} of {} scripts failed.", num_failures, paths.size());
+            }
+            return num_failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+
+        auto num_failures = 0uz;
+        for (auto const path : paths) {
+            try {
+                run_script(path, options);
+            } catch (std::exception const& e) {
+                std::println("{}", e.what());
+                ++num_failures;
+            }
+        }
+        if (paths.size() > 1 and num_failures > 0) {
+            std::println(stderr, "{} of {} scripts failed.", num_failures, paths.size());
+        }
+        return num_failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
     } catch (std::exception const& e) {
         std::println("{}", e.what());
         return EXIT_FAILURE;
@@ -0,0 +1,29 @@
+#include <array>
+#include <backseat/backseat.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+#include <utils/diagnostics.hpp>
+
+// A host that is built with `-fno-exceptions` (see `CMakeLists.txt`) and therefore only uses the `try_*` functions
+// of `backseat/backseat.hpp`. The second script fails at runtime, its diagnostic is printed after its output.
+
+int main() {
+    static constexpr auto scripts = std::array<std::string_view, 2>{
+        "println(\"Hello from a host without exceptions!\");\nprintln(6_u64 * 7_u64);\n",
+        "println(\"Dividing by zero...\");\nprintln(1_u64 / 0_u64);\n",
+    };
+
+    auto num_failures = 0;
+    auto output = interpreter::OutputSink::to_stdout();
+    for (auto const script : scripts) {
+        auto diagnostics = utils::Diagnostics{};
+        auto const program = backseat::try_compile(script, diagnostics);
+        if (not program.has_value() or not backseat::try_run(program.value(), output, diagnostics).has_value()) {
+            diagnostics.print(stderr);
+            ++num_failures;
+        }
+    }
+    // Only the second script is expected to fail.
+    return num_failures == 1 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,69 @@
+#include <algorithm>
+#include <backseat/output_sink.hpp>
+#include <cerrno>
+#include <interpreter/error.hpp>
+#include <poll.h>
+#include <span>
+#include <sys/uio.h>
+
+namespace interpreter {
+
+    auto OutputSink::write_all(std::span<iovec> vectors) const -> void {
+        while (not vectors.empty()) {
+            if (vectors.front().iov_len == 0) {
+                vectors = vectors.subspan(1);
+                continue;
+            }
+            auto const num_vectors = std::min(vectors.size(), max_num_vectors);
+            auto const written = ::writev(m_file_descriptor, vectors.data(), static_cast<int>(num_vectors));
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                if (errno == EAGAIN or errno == EWOULDBLOCK) {
+                    wait_until_writable();
+                    continue;
+                }
+                throw InterpreterError{ "Unable to write output." };
+            }
+            // Skip everything that has been written, which may end in the middle of a vector.
+            auto remaining = static_cast<usize>(written);
+            while (not vectors.empty() and remaining >= vectors.front().iov_len) {
+                remaining -= vectors.front().iov_len;
+                vectors = vectors.subspan(1);
+            }
+            if (not vectors.empty()) {
+                vectors.front().iov_base = static_cast<char*>(vectors.front().iov_base) + remaining;
+                vectors.front().iov_len -= remaining;
+            }
+        }
+    }
+
+    auto OutputSink::wait_until_writable() const -> void {
+        auto descriptor = pollfd{ m_file_descriptor, POLLOUT, 0 };
+        auto const timeout = m_write_timeout.count() < 0 ? -1 : static_cast<int>(m_write_timeout.count());
+        while (true) {
+            auto const num_ready = ::poll(&descriptor, 1, timeout);
+            if (num_ready > 0) {
+                return;
+            }
+            if (num_ready == 0) {
+                throw InterpreterError{ "Timed out while writing output." };
+            }
+            if (errno != EINTR) {
+                throw InterpreterError{ "Unable to write output." };
+            }
+        }
+    }
+
+    auto OutputSink::flush_or_discard() noexcept -> void {
+        try {
+            flush();
+        } catch (InterpreterError const&) {
+            m_vectors.clear();
+            m_size = 0;
+            m_run_start = 0;
+        }
+    }
+
+} // namespace interpreter
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <type_traits>
+#include <unistd.h>
+#include <utility>
+#include <utils/types.hpp>
+
+namespace interpreter {
+
+    // Owns a file descriptor and closes it on destruction.
+    class FileDescriptor final {
+    private:
+        int m_file_descriptor{ -1 };
+
+    public:
+        [[nodiscard]] FileDescriptor() = default;
+
+        [[nodiscard]] explicit FileDescriptor(int const file_descriptor)
+            : m_file_descriptor{ file_descriptor } { }
+
+        FileDescriptor(FileDescriptor const& other) = delete;
+
+        FileDescriptor(FileDescriptor&& other) noexcept
+            : m_file_descriptor{ std::exchange(other.m_file_descriptor, -1) } { }
+
+        FileDescriptor& operator=(FileDescriptor const& other) = delete;
+
+        FileDescriptor& operator=(FileDescriptor&& other) noexcept {
+            if (this != std::addressof(other)) {
+                close();
+                m_file_descriptor = std::exchange(other.m_file_descriptor, -1);
+            }
+            return *this;
+        }
+
+        ~FileDescriptor() {
+            close();
+        }
+
+        [[nodiscard]] auto get() const -> int {
+            return m_file_descriptor;
+        }
+
+        [[nodiscard]] auto is_valid() const -> bool {
+            return m_file_descriptor >= 0;
+        }
+
+    private:
+        auto close() noexcept -> void {
+            if (m_file_descriptor >= 0) {
+                ::close(m_file_descriptor);
+                m_file_descriptor = -1;
+            }
+        }
+    };
+
+    // The protocol between the compile server (`interpreter --serve=<socket>`) and `interpreter_client`. Both run
+    // on the same machine from the same build, so the headers are sent as raw bytes.
+    //
+    // A client sends any number of requests over one connection. Every request header carries the client's stdout
+    // as an `SCM_RIGHTS` control message, so the server writes the output of the script directly to it. The server
+    // answers every request with a response header, followed by the error message if the script has failed.
+    enum class ServerRequestKind : std::uint8_t {
+        RunFile,   // The name is a path that the server reads the script from.
+        RunSource, // The script is sent along with the request, the name is only used in error messages.
+    };
+
+    struct ServerRequestHeader final {
+        ServerRequestKind kind;
+        std::uint32_t name_length;
+        std::uint32_t source_length;
+    };
+
+    struct ServerResponseHeader final {
+        bool success;
+        std::uint32_t message_length;
+    };
+
+    static_assert(std::is_trivially_copyable_v<ServerRequestHeader>);
+    static_assert(std::is_trivially_copyable_v<ServerResponseHeader>);
+
+    // The server rejects requests with longer names or sources before allocating memory for them.
+    inline constexpr auto max_request_name_length = std::uint32_t{ 4 * 1024 };
+    inline constexpr auto max_request_source_length = std::uint32_t{ 64 * 1024 * 1024 };
+
+    [[nodiscard]] inline auto make_socket_address(std::string_view const path) -> sockaddr_un {
+        auto address = sockaddr_un{};
+        address.sun_family = AF_UNIX;
+        if (path.empty() or path.length() >= sizeof(address.sun_path)) {
+            throw std::invalid_argument{ std::format("Invalid socket path '{}'.", path) };
+        }
+        std::memcpy(address.sun_path, path.data(), path.length());
+        return address;
+    }
+
+    [[nodiscard]] inline auto connect_to_server(std::string_view const socket_path) -> FileDescriptor {
+        auto socket = FileDescriptor{ ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0) };
+        if (not socket.is_valid()) {
+            throw std::runtime_error{ "Unable to create socket." };
+        }
+        auto const address = make_socket_address(socket_path);
+        if (::connect(socket.get(), reinterpret_cast<sockaddr const*>(&address), sizeof(address)) != 0) {
+            throw std::runtime_error{ std::format("Unable to connect to '{}'.", socket_path) };
+        }
+        return socket;
+    }
+
+    inline auto send_all(int const socket, std::string_view data) -> void {
+        while (not data.empty()) {
+            auto const sent = ::send(socket, data.data(), data.size(), MSG_NOSIGNAL);
+            if (sent < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error{ "Unable to send data." };
+            }
+            data.remove_prefix(static_cast<usize>(sent));
+        }
+    }
+
+    // Distinguishes a receive timeout (see `SO_RCVTIMEO`) from other errors.
+    [[noreturn]] inline auto throw_receive_error() -> void {
+        if (errno == EAGAIN or errno == EWOULDBLOCK) {
+            throw std::runtime_error{ "Timed out while receiving data." };
+        }
+        throw std::runtime_error{ "Unable to receive data." };
+    }
+
+    // Returns `false` if the peer has closed the connection before sending anything.
+    [[nodiscard]] inline auto receive_all(int const socket, std::span<char> buffer) -> bool {
+        auto const size = buffer.size();
+        while (not buffer.empty()) {
+            auto const received = ::recv(socket, buffer.data(), buffer.size(), 0);
+            if (received < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw_receive_error();
+            }
+            if (received == 0) {
+                if (buffer.size() == size) {
+                    return false;
+                }
+                throw std::runtime_error{ "Connection closed unexpectedly." };
+            }
+            buffer = buffer.subspan(static_cast<usize>(received));
+        }
+        return true;
+    }
+
+    template<typename T>
+    [[nodiscard]] auto as_bytes(T const& value) -> std::string_view {
+        return std::string_view{ reinterpret_cast<char const*>(&value), sizeof(value) };
+    }
+
+    template<typename T>
+    [[nodiscard]] auto as_writable_bytes(T& value) -> std::span<char> {
+        return std::span{ reinterpret_cast<char*>(&value), sizeof(value) };
+    }
+
+    // Sends `data` and passes a duplicate of `file_descriptor` to the peer along with its first byte.
+    inline auto send_with_file_descriptor(int const socket, std::string_view const data, int const file_descriptor)
+            -> void {
+        auto control = std::array<char, CMSG_SPACE(sizeof(int))>{};
+        auto vector = iovec{ const_cast<char*>(data.data()), data.size() };
+        auto message = msghdr{};
+        message.msg_iov = &vector;
+        message.msg_iovlen = 1;
+        message.msg_control = control.data();
+        message.msg_controllen = control.size();
+        auto* const header = CMSG_FIRSTHDR(&message);
+        header->cmsg_level = SOL_SOCKET;
+        header->cmsg_type = SCM_RIGHTS;
+        header->cmsg_len = CMSG_LEN(sizeof(int));
+        std::memcpy(CMSG_DATA(header), &file_descriptor, sizeof(int));
+
+        auto sent = ::sendmsg(socket, &message, MSG_NOSIGNAL);
+        while (sent < 0 and errno == EINTR) {
+            sent = ::sendmsg(socket, &message, MSG_NOSIGNAL);
+        }
+        if (sent < 0) {
+            throw std::runtime_error{ "Unable to send data." };
+        }
+        send_all(socket, data.substr(static_cast<usize>(sent)));
+    }
+
+    // Counterpart of `send_with_file_descriptor()`. Returns an invalid descriptor if the peer has closed the
+    // connection before sending anything.
+    [[nodiscard]] inline auto receive_with_file_descriptor(int const socket, std::span<char> const buffer)
+            -> FileDescriptor {
+        auto control = std::array<char, CMSG_SPACE(sizeof(int))>{};
+        auto vector = iovec{ buffer.data(), buffer.size() };
+        auto message = msghdr{};
+        message.msg_iov = &vector;
+        message.msg_iovlen = 1;
+        message.msg_control = control.data();
+        message.msg_controllen = control.size();
+
+        auto received = ::recvmsg(socket, &message, MSG_CMSG_CLOEXEC);
+        while (received < 0 and errno == EINTR) {
+            received = ::recvmsg(socket, &message, MSG_CMSG_CLOEXEC);
+        }
+        if (received < 0) {
+            throw_receive_error();
+        }
+        if (received == 0) {
+            return FileDescriptor{};
+        }
+
+        auto file_descriptor = FileDescriptor{};
+        auto* const header = CMSG_FIRSTHDR(&message);
+        if (header != nullptr and header->cmsg_level == SOL_SOCKET and header->cmsg_type == SCM_RIGHTS) {
+            auto value = -1;
+            std::memcpy(&value, CMSG_DATA(header), sizeof(int));
+            file_descriptor = FileDescriptor{ value };
+        }
+        if (not file_descriptor.is_valid()) {
+            throw std::runtime_error{ "Request without output file descriptor." };
+        }
+        if (not receive_all(socket, buffer.subspan(static_cast<usize>(received)))) {
+            throw std::runtime_error{ "Connection closed unexpectedly." };
+        }
+        return file_descriptor;
+    }
+
+} // namespace interpreter
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <experimental/meta>
+#include <string>
+#include <tl/optional.hpp>
+#include <unordered_map>
+#include <utils/types.hpp>
+#include <vector>
+
+namespace ir {
+
+    // Every instruction defines exactly one value, which is identified by the index of the instruction. Since
+    // the language has no control flow, a program is a single basic block in SSA form.
+    using ValueId = std::uint32_t;
+
+    enum class Opcode : std::uint8_t {
+        Constant,     // immediate
+        String,       // strings[immediate]
+        Add,          // lhs + rhs
+        Subtract,     // lhs - rhs
+        Multiply,     // lhs * rhs
+        MultiplyHigh, // upper 64 bits of the 128-bit product lhs * rhs
+        Divide,       // lhs / rhs, fails if rhs == 0
+        Modulo,       // lhs mod rhs, fails if rhs == 0
+        ShiftLeft,    // lhs << rhs (rhs < 64)
+        ShiftRight,   // lhs >> rhs (rhs < 64)
+        BitwiseAnd,   // lhs & rhs
+        PrintU64,     // print(lhs)
+        PrintString,  // print(lhs)
+        PrintNewline, // println()
+    };
+
+    inline constexpr auto num_opcodes = enumerators_of(dealias(^^Opcode)).size();
+
+    struct Instruction final {
+        Opcode opcode;
+        std::uint64_t immediate{ 0 };
+        ValueId lhs{ 0 };
+        ValueId rhs{ 0 };
+    };
+
+    struct Program final {
+        std::vector<Instruction> instructions;
+        std::vector<std::string> strings;
+    };
+
+    [[nodiscard]] auto is_binary(Opcode opcode) -> bool;
+
+    // Instructions with side effects must neither be removed nor reordered. Division and modulo only count as
+    // side effects if their divisor is not known to be non-zero.
+    [[nodiscard]] auto has_side_effects(Program const& program, Instruction const& instruction) -> bool;
+
+    [[nodiscard]] auto multiply_high(std::uint64_t lhs, std::uint64_t rhs) -> std::uint64_t;
+
+    // Computes the result of a binary instruction. The divisor of `Divide` and `Modulo` must not be zero.
+    [[nodiscard]] auto fold(Opcode opcode, std::uint64_t lhs, std::uint64_t rhs) -> std::uint64_t;
+
+    [[nodiscard]] auto to_string(Program const& program) -> std::string;
+
+    // Appends instructions to a program. Equal constants and strings share a single value.
+    class Builder final {
+    private:
+        Program m_program;
+        std::unordered_map<std::uint64_t, ValueId> m_constants;
+        std::unordered_map<std::string, ValueId> m_strings;
+
+    public:
+        [[nodiscard]] auto constant(std::uint64_t value) -> ValueId;
+        [[nodiscard]] auto string(std::string value) -> ValueId;
+        [[nodiscard]] auto binary(Opcode opcode, ValueId lhs, ValueId rhs) -> ValueId;
+        auto print_u64(ValueId value) -> void;
+        auto print_string(ValueId value) -> void;
+        auto print_newline() -> void;
+
+        [[nodiscard]] auto constant_value(ValueId value) const -> tl::optional<std::uint64_t>;
+        [[nodiscard]] auto finish() && -> Program;
+
+    private:
+        [[nodiscard]] auto emit(Instruction instruction) -> ValueId;
+    };
+
+} // namespace ir
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "ir.hpp"
+#include <memory>
+#include <span>
+#include <type_checker/type_checker.hpp>
+
+namespace ir {
+
+    [[nodiscard]] auto lower(std::span<std::shared_ptr<type_checker::Statement const> const> statements) -> Program;
+
+} // namespace ir
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+
+namespace ir {
+
+    // Kept apart from `passes.hpp`, so that `backseat/backseat.hpp` can name it without pulling in the IR.
+    enum class OptimizationLevel : std::uint8_t {
+        O0, // No optimizations.
+        O1, // Constant propagation and dead value elimination.
+        O2, // Additionally algebraic simplification and strength reduction.
+        O3, // Additionally partial evaluation of the whole program.
+    };
+
+} // namespace ir
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "ir.hpp"
+#include "optimization_level.hpp"
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <tl/optional.hpp>
+#include <vector>
+
+namespace ir {
+
+    // Folds instructions whose operands are all constants. Divisions by zero are kept so that they fail at runtime.
+    [[nodiscard]] auto propagate_constants(Program const& program) -> Program;
+
+    // Applies identities like `x + 0 = x`, `x * 0 = 0` or `x - x = 0`.
+    [[nodiscard]] auto simplify_algebraically(Program const& program) -> Program;
+
+    // Replaces multiplications by powers of two with shifts and divisions by non-zero constants with
+    // multiply-high and shift sequences.
+    [[nodiscard]] auto reduce_strength(Program const& program) -> Program;
+
+    // Removes all instructions whose values are not (transitively) used by an instruction with side effects.
+    [[nodiscard]] auto eliminate_dead_values(Program const& program) -> Program;
+
+    // Runs everything that can be computed at compile time and merges the output of consecutive prints into a
+    // single string. Only operations that fail at runtime remain, together with the output that precedes them.
+    [[nodiscard]] auto evaluate_partially(Program const& program) -> Program;
+
+    // If the program does nothing but print a precomputed string (see `evaluate_partially()`), returns that string.
+    [[nodiscard]] auto output_blob(Program const& program) -> tl::optional<std::string_view>;
+
+    class PassManager final {
+    public:
+        using Pass = std::function<Program(Program const&)>;
+
+    private:
+        struct Entry final {
+            std::string_view name;
+            Pass pass;
+        };
+
+        std::vector<Entry> m_passes;
+
+    public:
+        [[nodiscard]] static auto for_level(OptimizationLevel level) -> PassManager;
+
+        auto add(std::string_view name, Pass pass) -> void;
+        [[nodiscard]] auto run(Program program) const -> Program;
+    };
+
+    [[nodiscard]] auto optimize(Program program, OptimizationLevel level) -> Program;
+
+} // namespace ir
@@ -0,0 +1,174 @@
+#include <format>
+#include <ir/ir.hpp>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <utils/enum_to_string.hpp>
+
+namespace ir {
+
+    [[nodiscard]] auto is_binary(Opcode const opcode) -> bool {
+        switch (opcode) {
+            case Opcode::Add:
+            case Opcode::Subtract:
+            case Opcode::Multiply:
+            case Opcode::MultiplyHigh:
+            case Opcode::Divide:
+            case Opcode::Modulo:
+            case Opcode::ShiftLeft:
+            case Opcode::ShiftRight:
+            case Opcode::BitwiseAnd:
+                return true;
+            case Opcode::Constant:
+            case Opcode::String:
+            case Opcode::PrintU64:
+            case Opcode::PrintString:
+            case Opcode::PrintNewline:
+                return false;
+        }
+        throw std::runtime_error{ "Unreachable" };
+    }
+
+    [[nodiscard]] auto has_side_effects(Program const& program, Instruction const& instruction) -> bool {
+        switch (instruction.opcode) {
+            case Opcode::PrintU64:
+            case Opcode::PrintString:
+            case Opcode::PrintNewline:
+                return true;
+            case Opcode::Divide:
+            case Opcode::Modulo: {
+                auto const& divisor = program.instructions.at(instruction.rhs);
+                return divisor.opcode != Opcode::Constant or divisor.immediate == 0;
+            }
+            default:
+                return false;
+        }
+    }
+
+    [[nodiscard]] auto multiply_high(std::uint64_t const lhs, std::uint64_t const rhs) -> std::uint64_t {
+        // Schoolbook multiplication of 32-bit halves, since `__int128` is not standard C++.
+        static constexpr auto low_mask = std::uint64_t{ 0xFFFF'FFFF };
+        auto const lhs_low = lhs & low_mask;
+        auto const lhs_high = lhs >> 32;
+        auto const rhs_low = rhs & low_mask;
+        auto const rhs_high = rhs >> 32;
+
+        auto const low_low = lhs_low * rhs_low;
+        auto const low_high = lhs_low * rhs_high;
+        auto const high_low = lhs_high * rhs_low;
+        auto const high_high = lhs_high * rhs_high;
+
+        auto const middle = (low_low >> 32) + (low_high & low_mask) + (high_low & low_mask);
+        return high_high + (low_high >> 32) + (high_low >> 32) + (middle >> 32);
+    }
+
+    [[nodiscard]] auto fold(Opcode const opcode, std::uint64_t const lhs, std::uint64_t const rhs) -> std::uint64_t {
+        switch (opcode) {
+            case Opcode::Add:
+                return lhs + rhs;
+            case Opcode::Subtract:
+                return lhs - rhs;
+            case Opcode::Multiply:
+                return lhs * rhs;
+            case Opcode::MultiplyHigh:
+                return multiply_high(lhs, rhs);
+            case Opcode::Divide:
+                return lhs / rhs;
+            case Opcode::Modulo:
+                return lhs % rhs;
+            case Opcode::ShiftLeft:
+                return lhs << rhs;
+            case Opcode::ShiftRight:
+                return lhs >> rhs;
+            case Opcode::BitwiseAnd:
+                return lhs & rhs;
+            default:
+                throw std::runtime_error{ "Not a binary instruction." };
+        }
+    }
+
+    [[nodiscard]] auto to_string(Program const& program) -> std::string {
+        auto result = std::string{};
+        for (auto i = 0uz; i < program.instructions.size(); ++i) {
+            auto const& [opcode, immediate, lhs, rhs] = program.instructions.at(i);
+            auto const name = utils::enum_to_string(opcode);
+            switch (opcode) {
+                case Opcode::Constant:
+                    result += std::format("%{} = {} {}\n", i, name, immediate);
+                    break;
+                case Opcode::String:
+                    result += std::format("%{} = {} {:?}\n", i, name, program.strings.at(immediate));
+                    break;
+                case Opcode::PrintU64:
+                case Opcode::PrintString:
+                    result += std::format("{} %{}\n", name, lhs);
+                    break;
+                case Opcode::PrintNewline:
+                    result += std::format("{}\n", name);
+                    break;
+                default:
+                    result += std::format("%{} = {} %{}, %{}\n", i, name, lhs, rhs);
+                    break;
+            }
+        }
+        return result;
+    }
+
+    [[nodiscard]] auto Builder::constant(std::uint64_t const value) -> ValueId {
+        if (auto const it = m_constants.find(value); it != m_constants.end()) {
+            return it->second;
+        }
+        auto const id = emit(Instruction{ Opcode::Constant, value });
+        m_constants.emplace(value, id);
+        return id;
+    }
+
+    [[nodiscard]] auto Builder::string(std::string value) -> ValueId {
+        if (auto const it = m_strings.find(value); it != m_strings.end()) {
+            return it->second;
+        }
+        auto const id = emit(Instruction{ Opcode::String, m_program.strings.size() });
+        m_program.strings.push_back(value);
+        m_strings.emplace(std::move(value), id);
+        return id;
+    }
+
+    [[nodiscard]] auto Builder::binary(Opcode const opcode, ValueId const lhs, ValueId const rhs) -> ValueId {
+        if (not is_binary(opcode)) {
+            throw std::invalid_argument{ "Not a binary instruction." };
+        }
+        return emit(Instruction{ opcode, 0, lhs, rhs });
+    }
+
+    auto Builder::print_u64(ValueId const value) -> void {
+        std::ignore = emit(Instruction{ Opcode::PrintU64, 0, value });
+    }
+
+    auto Builder::print_string(ValueId const value) -> void {
+        std::ignore = emit(Instruction{ Opcode::PrintString, 0, value });
+    }
+
+    auto Builder::print_newline() -> void {
+        std::ignore = emit(Instruction{ Opcode::PrintNewline });
+    }
+
+    [[nodiscard]] auto Builder::constant_value(ValueId const value) const -> tl::optional<std::uint64_t> {
+        auto const& instruction = m_program.instructions.at(value);
+        if (instruction.opcode != Opcode::Constant) {
+            return tl::nullopt;
+        }
+        return instruction.immediate;
+    }
+
+    [[nodiscard]] auto Builder::finish() && -> Program {
+        m_constants.clear();
+        m_strings.clear();
+        return std::move(m_program);
+    }
+
+    [[nodiscard]] auto Builder::emit(Instruction const instruction) -> ValueId {
+        m_program.instructions.push_back(instruction);
+        return static_cast<ValueId>(m_program.instructions.size() - 1);
+    }
+
+} // namespace ir
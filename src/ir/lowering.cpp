@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <experimental/meta>
+#include <ir/lowering.hpp>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+namespace ir {
+
+    namespace {
+        class Lowering final {
+        private:
+            Builder m_builder;
+            // Hash-consed expressions are lowered once, so shared subexpressions become shared values.
+            std::unordered_map<type_checker::ExpressionId, ValueId> m_lowered_expressions;
+
+        public:
+            [[nodiscard]] auto run(std::span<std::shared_ptr<type_checker::Statement const> const> const statements)
+                    -> Program {
+                for (auto const& statement : statements) {
+                    lower_statement(*statement);
+                }
+                return std::move(m_builder).finish();
+            }
+
+        private:
+            auto lower_print_argument(type_checker::Expression const& argument) -> void {
+                auto const value = lower_expression(argument);
+                if (argument.data_type() == type_checker::string_type) {
+                    m_builder.print_string(value);
+                } else if (argument.data_type() == type_checker::u64_type) {
+                    m_builder.print_u64(value);
+                } else {
+                    throw std::runtime_error{ "Unsupported data type for printing." };
+                }
+            }
+
+            auto lower(type_checker::Print const& statement) -> void {
+                lower_print_argument(*statement.argument());
+            }
+
+            auto lower(type_checker::Println const& statement) -> void {
+                lower_print_argument(*statement.argument());
+                m_builder.print_newline();
+            }
+
+            [[nodiscard]] auto lower(type_checker::StringLiteral const& expression) -> ValueId {
+                return m_builder.string(std::string{ expression.value() });
+            }
+
+            [[nodiscard]] auto lower(type_checker::UnsignedIntegerLiteral const& expression) -> ValueId {
+                return m_builder.constant(expression.value());
+            }
+
+            [[nodiscard]] auto lower(type_checker::BinaryOperator const& expression) -> ValueId {
+                auto const lhs = lower_expression(expression.lhs());
+                auto const rhs = lower_expression(expression.rhs());
+                return m_builder.binary(opcode_of(expression.operator_type()), lhs, rhs);
+            }
+
+            [[nodiscard]] static auto opcode_of(lexer::TokenType const operator_token_type) -> Opcode {
+                switch (operator_token_type) {
+                    case lexer::TokenType::Plus:
+                        return Opcode::Add;
+                    case lexer::TokenType::Minus:
+                        return Opcode::Subtract;
+                    case lexer::TokenType::Asterisk:
+                        return Opcode::Multiply;
+                    case lexer::TokenType::ForwardSlash:
+                        return Opcode::Divide;
+                    case lexer::TokenType::Mod:
+                        return Opcode::Modulo;
+                    default:
+                        throw std::runtime_error{ "Unsupported binary operator." };
+                }
+            }
+
+            auto lower_statement(type_checker::Statement const& statement) -> void {
+                static constexpr auto context = std::meta::access_context::current();
+                template for (constexpr auto member :
+                              std::define_static_array(members_of(^^type_checker, context))) {
+                    if constexpr (is_type(member) and is_class_type(member)) {
+                        static constexpr auto does_inherit_base =
+                                std::ranges::any_of(bases_of(member, context), [](auto const& base) {
+                                    return is_same_type(type_of(base), ^^type_checker::Statement);
+                                });
+                        if constexpr (does_inherit_base) {
+                            auto const downcasted = dynamic_cast<[:member:] const*>(std::addressof(statement));
+                            if (downcasted != nullptr) {
+                                return lower(*downcasted);
+                            }
+                        }
+                    }
+                }
+                throw std::runtime_error{ "Unreachable" };
+            }
+
+            [[nodiscard]] auto lower_expression(type_checker::Expression const& expression) -> ValueId {
+                if (auto const it = m_lowered_expressions.find(expression.id()); it != m_lowered_expressions.end()) {
+                    return it->second;
+                }
+                auto const value = lower_expression_uncached(expression);
+                m_lowered_expressions.emplace(expression.id(), value);
+                return value;
+            }
+
+            [[nodiscard]] auto lower_expression_uncached(type_checker::Expression const& expression) -> ValueId {
+                static constexpr auto context = std::meta::access_context::current();
+                template for (constexpr auto member :
+                              std::define_static_array(members_of(^^type_checker, context))) {
+                    if constexpr (is_type(member) and is_class_type(member)) {
+                        static constexpr auto does_inherit_base =
+                                std::ranges::any_of(bases_of(member, context), [](auto const& base) {
+                                    return is_same_type(type_of(base), ^^type_checker::Expression);
+                                });
+                        if constexpr (does_inherit_base) {
+                            auto const downcasted = dynamic_cast<[:member:] const*>(std::addressof(expression));
+                            if (downcasted != nullptr) {
+                                return lower(*downcasted);
+                            }
+                        }
+                    }
+                }
+                throw std::runtime_error{ "Unreachable" };
+            }
+        };
+    } // namespace
+
+    [[nodiscard]] auto lower(std::span<std::shared_ptr<type_checker::Statement const> const> const statements)
+            -> Program {
+        auto lowering = Lowering{};
+        return lowering.run(statements);
+    }
+
+} // namespace ir
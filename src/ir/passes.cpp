@@ -0,0 +1,376 @@
+#include <bit>
+#include <ir/passes.hpp>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace ir {
+
+    namespace {
+        // Copies an instruction into `builder`. `mapping` maps values of the source program to values of
+        // the builder.
+        auto copy_instruction(
+                Builder& builder,
+                Program const& program,
+                usize const index,
+                std::vector<ValueId>& mapping
+        ) -> void {
+            auto const& instruction = program.instructions.at(index);
+            switch (instruction.opcode) {
+                case Opcode::Constant:
+                    mapping.at(index) = builder.constant(instruction.immediate);
+                    break;
+                case Opcode::String:
+                    mapping.at(index) = builder.string(program.strings.at(instruction.immediate));
+                    break;
+                case Opcode::PrintU64:
+                    builder.print_u64(mapping.at(instruction.lhs));
+                    break;
+                case Opcode::PrintString:
+                    builder.print_string(mapping.at(instruction.lhs));
+                    break;
+                case Opcode::PrintNewline:
+                    builder.print_newline();
+                    break;
+                default: {
+                    auto const lhs = mapping.at(instruction.lhs);
+                    auto const rhs = mapping.at(instruction.rhs);
+                    mapping.at(index) = builder.binary(instruction.opcode, lhs, rhs);
+                    break;
+                }
+            }
+        }
+
+        // Rebuilds `program` in order. Every binary instruction is replaced by the value that
+        // `rewrite(builder, opcode, lhs, rhs)` returns, where `lhs` and `rhs` are already values of `builder`.
+        template<typename Rewrite>
+        [[nodiscard]] auto rewrite_binary_instructions(Program const& program, Rewrite const& rewrite) -> Program {
+            auto builder = Builder{};
+            auto mapping = std::vector<ValueId>(program.instructions.size());
+            for (auto i = 0uz; i < program.instructions.size(); ++i) {
+                auto const& instruction = program.instructions.at(i);
+                if (is_binary(instruction.opcode)) {
+                    mapping.at(i) = rewrite(
+                            builder,
+                            instruction.opcode,
+                            mapping.at(instruction.lhs),
+                            mapping.at(instruction.rhs)
+                    );
+                } else {
+                    copy_instruction(builder, program, i, mapping);
+                }
+            }
+            return std::move(builder).finish();
+        }
+
+        [[nodiscard]] auto is_constant(Builder const& builder, ValueId const value, std::uint64_t const expected)
+                -> bool {
+            return builder.constant_value(value) == expected;
+        }
+
+        // Computes `floor(high * 2^64 / divisor)` for `high < divisor` by binary long division.
+        [[nodiscard]] auto divide_wide(std::uint64_t const high, std::uint64_t const divisor) -> std::uint64_t {
+            auto remainder = high;
+            auto quotient = std::uint64_t{ 0 };
+            for (auto i = 0; i < 64; ++i) {
+                auto const carry = remainder >> 63;
+                remainder <<= 1;
+                quotient <<= 1;
+                // If a bit was shifted out, the remainder is at least 2^64 and therefore greater than the divisor.
+                if (carry != 0 or remainder >= divisor) {
+                    remainder -= divisor;
+                    quotient |= 1;
+                }
+            }
+            return quotient;
+        }
+
+        // Emits `dividend / divisor` for a constant divisor that is neither zero nor a power of two. With
+        // `l = ceil(log2(divisor))` and `m = floor(2^64 * (2^l - divisor) / divisor) + 1`, the quotient is
+        // `(t + ((dividend - t) >> 1)) >> (l - 1)` where `t = mulhi(m, dividend)` (Granlund and Montgomery).
+        [[nodiscard]] auto emit_division_by_constant(
+                Builder& builder,
+                ValueId const dividend,
+                std::uint64_t const divisor
+        ) -> ValueId {
+            auto const shift = static_cast<std::uint64_t>(std::bit_width(divisor - 1));
+            // For divisors above 2^63, `l` is 64 and `2^l - divisor` wraps around to `0 - divisor`.
+            auto const power_minus_divisor = (shift == 64 ? 0 - divisor : (std::uint64_t{ 1 } << shift) - divisor);
+            auto const magic = divide_wide(power_minus_divisor, divisor) + 1;
+
+            auto const high = builder.binary(Opcode::MultiplyHigh, dividend, builder.constant(magic));
+            auto const difference = builder.binary(Opcode::Subtract, dividend, high);
+            auto const half_difference = builder.binary(Opcode::ShiftRight, difference, builder.constant(1));
+            auto const sum = builder.binary(Opcode::Add, high, half_difference);
+            return builder.binary(Opcode::ShiftRight, sum, builder.constant(shift - 1));
+        }
+    } // namespace
+
+    [[nodiscard]] auto propagate_constants(Program const& program) -> Program {
+        return rewrite_binary_instructions(
+                program,
+                [](Builder& builder, Opcode const opcode, ValueId const lhs, ValueId const rhs) {
+                    auto const lhs_value = builder.constant_value(lhs);
+                    auto const rhs_value = builder.constant_value(rhs);
+                    auto const is_division = (opcode == Opcode::Divide or opcode == Opcode::Modulo);
+                    if (not lhs_value.has_value() or not rhs_value.has_value()
+                        or (is_division and rhs_value.value() == 0)) {
+                        return builder.binary(opcode, lhs, rhs);
+                    }
+                    return builder.constant(fold(opcode, lhs_value.value(), rhs_value.value()));
+                }
+        );
+    }
+
+    [[nodiscard]] auto simplify_algebraically(Program const& program) -> Program {
+        return rewrite_binary_instructions(
+                program,
+                [](Builder& builder, Opcode const opcode, ValueId const lhs, ValueId const rhs) {
+                    switch (opcode) {
+                        case Opcode::Add:
+                            if (is_constant(builder, rhs, 0)) {
+                                return lhs;
+                            }
+                            if (is_constant(builder, lhs, 0)) {
+                                return rhs;
+                            }
+                            break;
+                        case Opcode::Subtract:
+                            if (is_constant(builder, rhs, 0)) {
+                                return lhs;
+                            }
+                            if (lhs == rhs) {
+                                return builder.constant(0);
+                            }
+                            break;
+                        case Opcode::Multiply:
+                            if (is_constant(builder, rhs, 1)) {
+                                return lhs;
+                            }
+                            if (is_constant(builder, lhs, 1)) {
+                                return rhs;
+                            }
+                            if (is_constant(builder, lhs, 0) or is_constant(builder, rhs, 0)) {
+                                return builder.constant(0);
+                            }
+                            break;
+                        case Opcode::Divide:
+                            if (is_constant(builder, rhs, 1)) {
+                                return lhs;
+                            }
+                            break;
+                        case Opcode::Modulo:
+                            if (is_constant(builder, rhs, 1)) {
+                                return builder.constant(0);
+                            }
+                            break;
+                        case Opcode::ShiftLeft:
+                        case Opcode::ShiftRight:
+                            if (is_constant(builder, rhs, 0)) {
+                                return lhs;
+                            }
+                            break;
+                        case Opcode::BitwiseAnd:
+                            if (is_constant(builder, lhs, 0) or is_constant(builder, rhs, 0)) {
+                                return builder.constant(0);
+                            }
+                            break;
+                        default:
+                            break;
+                    }
+                    return builder.binary(opcode, lhs, rhs);
+                }
+        );
+    }
+
+    [[nodiscard]] auto reduce_strength(Program const& program) -> Program {
+        return rewrite_binary_instructions(
+                program,
+                [](Builder& builder, Opcode const opcode, ValueId const lhs, ValueId const rhs) {
+                    auto const divisor = builder.constant_value(rhs);
+                    // Divisions by zero must still fail at runtime, divisions by one are handled by
+                    // `simplify_algebraically()`.
+                    if (not divisor.has_value() or divisor.value() < 2) {
+                        return builder.binary(opcode, lhs, rhs);
+                    }
+                    auto const is_power_of_two = std::has_single_bit(divisor.value());
+                    auto const exponent = static_cast<std::uint64_t>(std::countr_zero(divisor.value()));
+                    switch (opcode) {
+                        case Opcode::Multiply:
+                            if (is_power_of_two) {
+                                return builder.binary(Opcode::ShiftLeft, lhs, builder.constant(exponent));
+                            }
+                            break;
+                        case Opcode::Divide:
+                            if (is_power_of_two) {
+                                return builder.binary(Opcode::ShiftRight, lhs, builder.constant(exponent));
+                            }
+                            return emit_division_by_constant(builder, lhs, divisor.value());
+                        case Opcode::Modulo: {
+                            if (is_power_of_two) {
+                                return builder.binary(Opcode::BitwiseAnd, lhs, builder.constant(divisor.value() - 1));
+                            }
+                            auto const quotient = emit_division_by_constant(builder, lhs, divisor.value());
+                            auto const product = builder.binary(Opcode::Multiply, quotient, rhs);
+                            return builder.binary(Opcode::Subtract, lhs, product);
+                        }
+                        default:
+                            break;
+                    }
+                    return builder.binary(opcode, lhs, rhs);
+                }
+        );
+    }
+
+    [[nodiscard]] auto eliminate_dead_values(Program const& program) -> Program {
+        auto is_live = std::vector<bool>(program.instructions.size(), false);
+        // Operands always precede their users, so a single backwards sweep finds all live values.
+        for (auto i = program.instructions.size(); i > 0; --i) {
+            auto const& instruction = program.instructions.at(i - 1);
+            if (has_side_effects(program, instruction)) {
+                is_live.at(i - 1) = true;
+            }
+            if (not is_live.at(i - 1)) {
+                continue;
+            }
+            if (is_binary(instruction.opcode)) {
+                is_live.at(instruction.lhs) = true;
+                is_live.at(instruction.rhs) = true;
+            } else if (instruction.opcode == Opcode::PrintU64 or instruction.opcode == Opcode::PrintString) {
+                is_live.at(instruction.lhs) = true;
+            }
+        }
+
+        auto builder = Builder{};
+        auto mapping = std::vector<ValueId>(program.instructions.size());
+        for (auto i = 0uz; i < program.instructions.size(); ++i) {
+            if (is_live.at(i)) {
+                copy_instruction(builder, program, i, mapping);
+            }
+        }
+        return std::move(builder).finish();
+    }
+
+    [[nodiscard]] auto evaluate_partially(Program const& program) -> Program {
+        auto builder = Builder{};
+        auto mapping = std::vector<ValueId>(program.instructions.size());
+        auto known_values = std::vector<tl::optional<std::uint64_t>>(program.instructions.size());
+        auto pending_output = std::string{};
+        auto const flush_output = [&] {
+            if (not pending_output.empty()) {
+                builder.print_string(builder.string(std::exchange(pending_output, std::string{})));
+            }
+        };
+
+        for (auto i = 0uz; i < program.instructions.size(); ++i) {
+            auto const& instruction = program.instructions.at(i);
+            switch (instruction.opcode) {
+                case Opcode::Constant:
+                    known_values.at(i) = instruction.immediate;
+                    mapping.at(i) = builder.constant(instruction.immediate);
+                    continue;
+                case Opcode::String:
+                    // Strings can only be printed, so they do not have to be copied until they are used.
+                    continue;
+                case Opcode::PrintU64:
+                    if (known_values.at(instruction.lhs).has_value()) {
+                        pending_output += std::to_string(known_values.at(instruction.lhs).value());
+                        continue;
+                    }
+                    flush_output();
+                    builder.print_u64(mapping.at(instruction.lhs));
+                    continue;
+                case Opcode::PrintString: {
+                    auto const& string = program.instructions.at(instruction.lhs);
+                    pending_output += program.strings.at(string.immediate);
+                    continue;
+                }
+                case Opcode::PrintNewline:
+                    pending_output += '\n';
+                    continue;
+                default:
+                    break;
+            }
+
+            auto const lhs = known_values.at(instruction.lhs);
+            auto const rhs = known_values.at(instruction.rhs);
+            auto const is_division = (instruction.opcode == Opcode::Divide or instruction.opcode == Opcode::Modulo);
+            if (lhs.has_value() and rhs.has_value() and not (is_division and rhs.value() == 0)) {
+                known_values.at(i) = fold(instruction.opcode, lhs.value(), rhs.value());
+                mapping.at(i) = builder.constant(known_values.at(i).value());
+                continue;
+            }
+
+            // The output so far has to be written before the instruction fails (or the following output that
+            // depends on it is written).
+            flush_output();
+            auto const lhs_operand = mapping.at(instruction.lhs);
+            auto const rhs_operand = mapping.at(instruction.rhs);
+            mapping.at(i) = builder.binary(instruction.opcode, lhs_operand, rhs_operand);
+            if (is_division and rhs == std::uint64_t{ 0 }) {
+                // Always fails, so the rest of the program is unreachable.
+                return std::move(builder).finish();
+            }
+        }
+        flush_output();
+        return std::move(builder).finish();
+    }
+
+    [[nodiscard]] auto output_blob(Program const& program) -> tl::optional<std::string_view> {
+        auto const& instructions = program.instructions;
+        if (instructions.empty()) {
+            return std::string_view{};
+        }
+        if (instructions.size() != 2 or instructions.at(0).opcode != Opcode::String
+            or instructions.at(1).opcode != Opcode::PrintString) {
+            return tl::nullopt;
+        }
+        return std::string_view{ program.strings.at(instructions.at(0).immediate) };
+    }
+
+    [[nodiscard]] auto PassManager::for_level(OptimizationLevel const level) -> PassManager {
+        auto pass_manager = PassManager{};
+        switch (level) {
+            case OptimizationLevel::O0:
+                break;
+            case OptimizationLevel::O1:
+                pass_manager.add("constant propagation", propagate_constants);
+                pass_manager.add("dead value elimination", eliminate_dead_values);
+                break;
+            case OptimizationLevel::O2:
+                pass_manager.add("constant propagation", propagate_constants);
+                pass_manager.add("algebraic simplification", simplify_algebraically);
+                pass_manager.add("strength reduction", reduce_strength);
+                // Strength reduction introduces new constants that may be folded.
+                pass_manager.add("constant propagation", propagate_constants);
+                pass_manager.add("dead value elimination", eliminate_dead_values);
+                break;
+            case OptimizationLevel::O3:
+                pass_manager.add("constant propagation", propagate_constants);
+                pass_manager.add("algebraic simplification", simplify_algebraically);
+                pass_manager.add("partial evaluation", evaluate_partially);
+                // Only runs on what partial evaluation left for runtime.
+                pass_manager.add("strength reduction", reduce_strength);
+                pass_manager.add("constant propagation", propagate_constants);
+                pass_manager.add("dead value elimination", eliminate_dead_values);
+                break;
+        }
+        return pass_manager;
+    }
+
+    auto PassManager::add(std::string_view const name, Pass pass) -> void {
+        m_passes.push_back(Entry{ name, std::move(pass) });
+    }
+
+    [[nodiscard]] auto PassManager::run(Program program) const -> Program {
+        for (auto const& [name, pass] : m_passes) {
+            program = pass(program);
+        }
+        return program;
+    }
+
+    [[nodiscard]] auto optimize(Program program, OptimizationLevel const level) -> Program {
+        return PassManager::for_level(level).run(std::move(program));
+    }
+
+} // namespace ir
@@ -1,7 +1,10 @@
 #pragma once
 
 #include "token.hpp"
+#include <expected>
+#include <stdexcept>
 #include <string_view>
+#include <utils/diagnostics.hpp>
 #include <vector>
 
 namespace lexer {
@@ -21,4 +24,11 @@ namespace lexer {
         std::string_view filename,
         std::string_view source
     ) -> std::vector<Token>;
+
+    // Like `tokenize()`, but reports errors to `diagnostics` instead of throwing.
+    [[nodiscard]] auto try_tokenize(
+        std::string_view filename,
+        std::string_view source,
+        utils::Diagnostics& diagnostics
+    ) -> std::expected<std::vector<Token>, utils::DiagnosticKind>;
 }
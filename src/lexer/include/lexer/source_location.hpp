@@ -1,5 +1,7 @@
 #pragma once
 
+#include <format>
+#include <string>
 #include <string_view>
 #include <utils/types.hpp>
 #include <print>
@@ -24,7 +26,7 @@ namespace lexer {
         usize m_length;
 
     public:
-        [[nodiscard]] SourceLocation(
+        [[nodiscard]] constexpr SourceLocation(
             std::string_view const filename,
             std::string_view const source,
             usize const offset,
@@ -35,19 +37,19 @@ namespace lexer {
               m_offset(offset),
               m_length(length) { }
 
-        [[nodiscard]] auto filename() const -> std::string_view {
+        [[nodiscard]] constexpr auto filename() const -> std::string_view {
             return m_filename;
         }
 
-        [[nodiscard]] auto offset() const -> usize {
+        [[nodiscard]] constexpr auto offset() const -> usize {
             return m_offset;
         }
 
-        [[nodiscard]] auto length() const -> usize {
+        [[nodiscard]] constexpr auto length() const -> usize {
             return m_length;
         }
 
-        [[nodiscard]] auto lexeme() const -> std::string_view {
+        [[nodiscard]] constexpr auto lexeme() const -> std::string_view {
             return m_source.substr(m_offset, m_length);
         }
 
@@ -64,6 +66,12 @@ namespace lexer {
             return SourcePosition{ .line = line, .column = column };
         }
 
+        // "filename:line:column", as expected by `utils::Diagnostics::report()`.
+        [[nodiscard]] auto format_position() const -> std::string {
+            auto const [line, column] = position();
+            return std::format("{}:{}:{}", m_filename, line, column);
+        }
+
         [[nodiscard]] auto line() const -> std::string_view {
             auto start = m_source.rfind('\n', m_offset);
             if (start == decltype(m_source)::npos) {
@@ -11,14 +11,14 @@ namespace lexer {
         TokenType m_type;
 
     public:
-        [[nodiscard]] Token(SourceLocation const& source_location, TokenType const type)
+        [[nodiscard]] constexpr Token(SourceLocation const& source_location, TokenType const type)
             : m_source_location{ source_location }, m_type{ type } { }
 
-        [[nodiscard]] auto source_location() const -> SourceLocation const& {
+        [[nodiscard]] constexpr auto source_location() const -> SourceLocation const& {
             return m_source_location;
         }
 
-        [[nodiscard]] auto type() const -> TokenType {
+        [[nodiscard]] constexpr auto type() const -> TokenType {
             return m_type;
         }
     };
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "lexer.hpp"
+#include "token.hpp"
+#include <array>
+#include <expected>
+#include <experimental/meta>
+#include <generated.hpp>
+#include <optional>
+#include <ranges>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace lexer {
+    struct PatternState final {
+        bool is_matching;
+        usize state_index;
+    };
+
+    struct LexerState final {
+        std::array<PatternState, patterns.size()> pattern_states{};
+    };
+
+    // Runs all generated patterns (see `pattern_generator`) in lockstep over the source. Usable at compile time,
+    // so that `embedded::compile()` accepts exactly the tokens that `tokenize()` accepts.
+    class Lexer final {
+    private:
+        std::string_view m_filename;
+        std::string_view m_source;
+        std::vector<Token> m_tokens;
+        usize m_offset{ 0 };
+
+    public:
+        [[nodiscard]] constexpr Lexer(std::string_view const filename, std::string_view const source)
+            : m_filename{ filename }, m_source{ source } { }
+
+        // Doesn't throw, so that it can be used in builds without exceptions.
+        [[nodiscard]] constexpr auto tokenize() -> std::expected<std::vector<Token>, LexerError> {
+            m_offset = 0uz;
+            while (m_tokens.empty() or m_tokens.at(m_tokens.size() - 1).type() != TokenType::EndOfFile) {
+                auto const start_offset = m_offset;
+                static constexpr auto initial_lexer_state = [] {
+                    auto state = LexerState{};
+                    state.pattern_states.fill(PatternState{ .is_matching = true, .state_index = 0uz });
+                    return state;
+                }();
+                auto const matched_token_type = match(initial_lexer_state);
+                if (not matched_token_type.has_value()) {
+                    return std::unexpected{ LexerError{
+                        "Invalid token.",
+                        SourceLocation{
+                            m_filename,
+                            m_source,
+                            start_offset,
+                            m_offset - start_offset,
+                        },
+                    } };
+                }
+
+                auto const should_emit = patterns.at(std::to_underlying(matched_token_type.value())).should_emit;
+                if (not should_emit) {
+                    continue;
+                }
+
+                auto const source_location = SourceLocation{
+                    m_filename,
+                    m_source,
+                    start_offset,
+                    m_offset - start_offset,
+                };
+                m_tokens.emplace_back(source_location, matched_token_type.value());
+            }
+            return std::move(m_tokens);
+        }
+
+    private:
+        // Advances over the longest prefix that is matched by any pattern. A loop instead of (tail) recursion, so
+        // that long tokens don't exceed the depth limit of constant evaluation.
+        constexpr auto match(LexerState lexer_state) -> std::optional<TokenType> {
+            using std::views::iota;
+
+            while (true) {
+                auto next_lexer_state = lexer_state;
+                auto any_pattern_matched = false;
+
+                template for (constexpr auto pattern_state_index : iota(0uz, patterns.size())) {
+                    if (lexer_state.pattern_states.at(pattern_state_index).is_matching) {
+                        static constexpr auto& states = patterns
+                            .at(pattern_state_index)
+                            .states;
+                        auto does_this_pattern_match = false;
+                        for (auto const& transition : states
+                            .at(lexer_state.pattern_states.at(pattern_state_index).state_index)
+                            .transitions
+                        ) {
+                            if (transition.char_mask.contains(current())) {
+                                next_lexer_state.pattern_states.at(pattern_state_index).state_index =
+                                    transition.next_state;
+                                any_pattern_matched = true;
+                                does_this_pattern_match = true;
+                                break;
+                            }
+                        }
+                        next_lexer_state.pattern_states.at(pattern_state_index).is_matching = does_this_pattern_match;
+                    }
+                }
+
+                if (not any_pattern_matched) {
+                    break;
+                }
+                advance();
+                lexer_state = next_lexer_state;
+            }
+
+            for (auto const i : iota(0uz, lexer_state.pattern_states.size())) {
+                auto const& pattern_state = lexer_state.pattern_states.at(i);
+                if (
+                    pattern_state.state_index == 0uz
+                    or not pattern_state.is_matching
+                    or not patterns.at(i).states.at(lexer_state.pattern_states.at(i).state_index).is_final
+                ) {
+                    continue;
+                }
+                return TokenType{ i };
+            }
+            return std::nullopt;
+        }
+
+        [[nodiscard]] constexpr auto is_at_end() const -> bool {
+            return m_offset >= m_source.size();
+        }
+
+        [[nodiscard]] constexpr auto current() const -> char {
+            if (is_at_end()) {
+                return '\0';
+            }
+            return m_source.at(m_offset);
+        }
+
+        constexpr auto advance() -> void {
+            if (is_at_end()) {
+                return;
+            }
+            ++m_offset;
+        }
+    };
+}
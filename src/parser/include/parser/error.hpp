@@ -1,10 +1,24 @@
 #pragma once
 
+#include <lexer/source_location.hpp>
 #include <stdexcept>
+#include <tl/optional.hpp>
 
 namespace parser {
     class ParserError final : public std::runtime_error {
+    private:
+        tl::optional<lexer::SourceLocation> m_source_location;
+
     public:
         [[nodiscard]] explicit ParserError(std::string const& basic_string) : runtime_error{ basic_string } { }
+
+        [[nodiscard]] explicit ParserError(std::string const& message, lexer::SourceLocation const& source_location)
+            : runtime_error{ message },
+              m_source_location{ source_location } { }
+
+        // The location of the offending token, if there is one.
+        [[nodiscard]] auto source_location() const -> tl::optional<lexer::SourceLocation> const& {
+            return m_source_location;
+        }
     };
 }
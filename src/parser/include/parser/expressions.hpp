@@ -1,21 +1,33 @@
 #pragma once
 
 #include "error.hpp"
-#include <charconv>
+#include <cstdint>
 #include <lexer/token.hpp>
 #include <tl/optional.hpp>
+#include <utils/digits.hpp>
 
 namespace parser {
     class StringLiteral;
 
+    // Identifies an expression node within the parse tree it belongs to. Ids are assigned in creation order,
+    // starting at zero, so they can be used to index side tables.
+    using NodeId = std::uint32_t;
+
     class Expression {
+    private:
+        NodeId m_id;
+
     public:
-        [[nodiscard]] Expression() = default;
+        [[nodiscard]] explicit Expression(NodeId const id) : m_id{ id } { }
         Expression(Expression const& other) = delete;
         Expression(Expression&& other) noexcept = default;
         Expression& operator=(Expression const& other) = delete;
         Expression& operator=(Expression&& other) noexcept = default;
         virtual ~Expression() = default;
+
+        [[nodiscard]] auto id() const -> NodeId {
+            return m_id;
+        }
     };
 
     class StringLiteral final : public Expression {
@@ -23,7 +35,9 @@ namespace parser {
         lexer::Token m_token;
 
     public:
-        [[nodiscard]] explicit StringLiteral(lexer::Token const& token) : m_token{ token } { }
+        [[nodiscard]] explicit StringLiteral(NodeId const id, lexer::Token const& token)
+            : Expression{ id },
+              m_token{ token } { }
 
         [[nodiscard]] auto token() const -> lexer::Token const& {
             return m_token;
@@ -33,23 +47,38 @@ namespace parser {
     class UnsignedIntegerLiteral final : public Expression {
     private:
         lexer::Token m_token;
+        std::uint64_t m_value;
 
     public:
-        [[nodiscard]] explicit UnsignedIntegerLiteral(lexer::Token const& token) : m_token{ token } {
-            static constexpr auto suffix_length = std::string_view{ "_u64" }.length();
-            auto const without_suffix =
-                    m_token.source_location().lexeme().substr(0, m_token.source_location().length() - suffix_length);
-            auto value = std::uint64_t{};
-            auto const [_, ec] =
-                    std::from_chars(without_suffix.data(), without_suffix.data() + without_suffix.length(), value);
-            if (ec == std::errc::result_out_of_range) {
-                throw ParserError{ "Unsigned integer literal out of range." };
-            }
-        }
+        [[nodiscard]] explicit UnsignedIntegerLiteral(NodeId const id, lexer::Token const& token)
+            : Expression{ id },
+              m_token{ token },
+              m_value{ decode(token) } { }
 
         [[nodiscard]] auto token() const -> lexer::Token const& {
             return m_token;
         }
+
+        // Decoded once during parsing, so that later stages don't have to look at the lexeme again.
+        [[nodiscard]] auto value() const -> std::uint64_t {
+            return m_value;
+        }
+
+    private:
+        [[nodiscard]] static auto decode(lexer::Token const& token) -> std::uint64_t {
+            static constexpr auto suffix_length = std::string_view{ "_u64" }.length();
+            auto const lexeme = token.source_location().lexeme();
+            auto const value = utils::parse_decimal(lexeme.substr(0, lexeme.length() - suffix_length), '\'');
+            if (not value.has_value()) {
+                switch (value.error()) {
+                    case utils::DecimalParseError::InvalidDigit:
+                        throw ParserError{ "Invalid unsigned integer literal.", token.source_location() };
+                    case utils::DecimalParseError::OutOfRange:
+                        throw ParserError{ "Unsigned integer literal out of range.", token.source_location() };
+                }
+            }
+            return value.value();
+        }
     };
 
     class BinaryOperator final : public Expression {
@@ -60,11 +89,13 @@ namespace parser {
 
     public:
         [[nodiscard]] explicit BinaryOperator(
+                NodeId const id,
                 std::unique_ptr<Expression> lhs,
                 lexer::Token const& operator_token,
                 std::unique_ptr<Expression> rhs
         )
-            : m_lhs{ std::move(lhs) },
+            : Expression{ id },
+              m_lhs{ std::move(lhs) },
               m_operator_token{ operator_token },
               m_rhs{ std::move(rhs) } { }
 
@@ -1,12 +1,18 @@
 #pragma once
 
+#include <expected>
 #include <span>
 #include "statements.hpp"
 #include <lexer/token.hpp>
+#include <utils/diagnostics.hpp>
 #include <vector>
 #include <memory>
 #include "error.hpp"
 
 namespace parser {
     [[nodiscard]] auto parse(std::span<lexer::Token const> tokens) -> std::vector<std::unique_ptr<Statement>>;
+
+    // Like `parse()`, but reports errors to `diagnostics` instead of throwing.
+    [[nodiscard]] auto try_parse(std::span<lexer::Token const> tokens, utils::Diagnostics& diagnostics)
+            -> std::expected<std::vector<std::unique_ptr<Statement>>, utils::DiagnosticKind>;
 }
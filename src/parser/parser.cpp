@@ -1,5 +1,7 @@
 #include "parser_table.hpp"
 #include "precedence.hpp"
+#include <exception>
+#include <expected>
 #include <format>
 #include <memory>
 #include <parser/parser.hpp>
@@ -14,6 +16,7 @@ namespace parser {
     private:
         std::span<lexer::Token const> m_tokens;
         usize m_index{};
+        NodeId m_next_node_id{};
 
     public:
         [[nodiscard]] Parser(std::span<lexer::Token const> tokens) : m_tokens{ tokens } {
@@ -24,6 +27,7 @@ namespace parser {
 
         [[nodiscard]] auto parse() -> std::vector<std::unique_ptr<Statement>> {
             m_index = 0uz;
+            m_next_node_id = 0;
             auto statements = std::vector<std::unique_ptr<Statement>>{};
             while (not is_at_end()) {
                 statements.push_back(statement());
@@ -50,6 +54,10 @@ namespace parser {
             return m_tokens.back();
         }
 
+        [[nodiscard]] auto next_node_id() -> NodeId {
+            return m_next_node_id++;
+        }
+
         [[nodiscard]] auto match(lexer::TokenType const type) -> tl::optional<lexer::Token const&> {
             if (current().type() != type) {
                 return tl::nullopt;
@@ -60,11 +68,14 @@ namespace parser {
         auto expect(lexer::TokenType const type) -> lexer::Token const& {
             auto const matched = match(type);
             if (not matched.has_value()) {
-                throw ParserError{ std::format(
-                        "Expected token type '{}', got '{}'.",
-                        utils::enum_to_string(type),
-                        utils::enum_to_string(current().type())
-                ) };
+                throw ParserError{
+                    std::format(
+                            "Expected token type '{}', got '{}'.",
+                            utils::enum_to_string(type),
+                            utils::enum_to_string(current().type())
+                    ),
+                    current().source_location(),
+                };
             }
             return matched.value();
         }
@@ -85,14 +96,18 @@ namespace parser {
                 expect(TokenType::Semicolon);
                 return std::make_unique<Println>(std::move(argument));
             }
-            throw ParserError{ std::format("Unexpected token '{}'.", utils::enum_to_string(current().type())) };
+            throw ParserError{
+                std::format("Unexpected token '{}'.", utils::enum_to_string(current().type())),
+                current().source_location(),
+            };
         }
 
         [[nodiscard]] auto expression(Precedence const precedence) -> std::unique_ptr<Expression> {
             auto const prefix_parser = current_table_record().prefix_parser;
             if (prefix_parser == nullptr) {
                 throw ParserError{
-                    std::format("Unexpected token of type '{}'.", utils::enum_to_string(current().type()))
+                    std::format("Unexpected token of type '{}'.", utils::enum_to_string(current().type())),
+                    current().source_location(),
                 };
             }
             auto first_operand = std::invoke(prefix_parser, *this);
@@ -108,18 +123,25 @@ namespace parser {
         }
 
         [[nodiscard]] auto string_literal() -> std::unique_ptr<Expression> {
-            return std::make_unique<StringLiteral>(expect(lexer::TokenType::StringLiteral));
+            auto const& token = expect(lexer::TokenType::StringLiteral);
+            return std::make_unique<StringLiteral>(next_node_id(), token);
         }
 
         [[nodiscard]] auto unsigned_integer_literal() -> std::unique_ptr<Expression> {
-            return std::make_unique<UnsignedIntegerLiteral>(expect(lexer::TokenType::UnsignedIntegerLiteral));
+            auto const& token = expect(lexer::TokenType::UnsignedIntegerLiteral);
+            return std::make_unique<UnsignedIntegerLiteral>(next_node_id(), token);
         }
 
         [[nodiscard]] auto binary(std::unique_ptr<Expression> left_operand) -> std::unique_ptr<Expression> {
             auto const [_, _, precedence] = current_table_record();
             auto const operator_token = advance();
             auto right_operand = expression(precedence);
-            return std::make_unique<BinaryOperator>(std::move(left_operand), operator_token, std::move(right_operand));
+            return std::make_unique<BinaryOperator>(
+                    next_node_id(),
+                    std::move(left_operand),
+                    operator_token,
+                    std::move(right_operand)
+            );
         }
 
         [[nodiscard]] auto group() -> std::unique_ptr<Expression> {
@@ -129,7 +151,7 @@ namespace parser {
             return inside_expression;
         }
 
-        static inline auto parser_table = create_parser_table(
+        static inline auto const parser_table = create_parser_table(
                 ParserTableEntry<lexer::TokenType::Print>{ nullptr, nullptr, Precedence::Unknown },
                 ParserTableEntry<lexer::TokenType::Println>{ nullptr, nullptr, Precedence::Unknown },
                 ParserTableEntry<lexer::TokenType::LowercaseFunction>{ nullptr, nullptr, Precedence::Unknown },
@@ -200,4 +222,23 @@ namespace parser {
         return parser.parse();
     }
 
+    [[nodiscard]] auto try_parse(std::span<lexer::Token const> const tokens, utils::Diagnostics& diagnostics)
+            -> std::expected<std::vector<std::unique_ptr<Statement>>, utils::DiagnosticKind> {
+        try {
+            return parse(tokens);
+        } catch (ParserError const& error) {
+            auto location = std::string{};
+            if (error.source_location().has_value()) {
+                location = error.source_location()->format_position();
+            }
+            diagnostics.report(utils::DiagnosticKind::ParserError, error.what(), std::move(location));
+        } catch (std::exception const& error) {
+            // E.g. `std::bad_alloc`. Callers rely on `try_parse()` not throwing.
+            diagnostics.report(utils::DiagnosticKind::ParserError, error.what());
+        } catch (...) {
+            diagnostics.report(utils::DiagnosticKind::ParserError, "Unknown error.");
+        }
+        return std::unexpected{ utils::DiagnosticKind::ParserError };
+    }
+
 } // namespace parser
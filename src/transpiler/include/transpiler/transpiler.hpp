@@ -0,0 +1,15 @@
+#pragma once
+
+#include <memory>
+#include <span>
+#include <string>
+#include <type_checker/type_checker.hpp>
+
+namespace transpiler {
+
+    // Translates a type checked program into a standalone C++ translation unit. The generated program writes the
+    // same output as the interpreter: `U64` arithmetic wraps around and a division by zero prints an error and
+    // exits with `EXIT_FAILURE`.
+    [[nodiscard]] auto transpile(std::span<std::unique_ptr<type_checker::Statement> const> statements) -> std::string;
+
+} // namespace transpiler
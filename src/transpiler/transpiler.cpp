@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <experimental/meta>
+#include <format>
+#include <stdexcept>
+#include <string_view>
+#include <transpiler/transpiler.hpp>
+
+namespace transpiler {
+
+    namespace {
+        // The generated code only depends on the C++17 standard library, so it can be compiled with any toolchain.
+        constexpr auto prologue = std::string_view{
+            R"(// Generated by the backseat transpiler. Do not edit.
+#include <cinttypes>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+    [[noreturn]] void division_by_zero() {
+        std::fputs("Division by zero.\n", stdout);
+        std::exit(EXIT_FAILURE);
+    }
+
+    inline std::uint64_t divide(std::uint64_t const lhs, std::uint64_t const rhs) {
+        if (rhs == 0) {
+            division_by_zero();
+        }
+        return lhs / rhs;
+    }
+
+    inline std::uint64_t modulo(std::uint64_t const lhs, std::uint64_t const rhs) {
+        if (rhs == 0) {
+            division_by_zero();
+        }
+        return lhs % rhs;
+    }
+
+    inline void print_u64(std::uint64_t const value) {
+        std::printf("%" PRIu64, value);
+    }
+
+    inline void print_string(char const* const data, std::size_t const length) {
+        std::fwrite(data, 1, length, stdout);
+    }
+
+    inline void print_newline() {
+        std::fputc('\n', stdout);
+    }
+} // namespace
+
+int main() {
+)"
+        };
+
+        constexpr auto epilogue = std::string_view{
+            R"(    return EXIT_SUCCESS;
+}
+)"
+        };
+
+        // Escapes everything but printable ASCII characters. Octal escapes are used since, unlike hexadecimal
+        // escapes, they never consume the following character.
+        [[nodiscard]] auto to_cpp_string_literal(std::string_view const text) -> std::string {
+            auto result = std::string{ "\"" };
+            for (auto const c : text) {
+                auto const byte = static_cast<unsigned char>(c);
+                if (c == '"' or c == '\\' or c == '?') {
+                    result += '\\';
+                    result += c;
+                } else if (byte < 0x20 or byte >= 0x7F) {
+                    result += std::format("\\{:03o}", byte);
+                } else {
+                    result += c;
+                }
+            }
+            result += '"';
+            return result;
+        }
+
+        class Transpiler final {
+        private:
+            std::string m_output;
+
+        public:
+            [[nodiscard]] auto run(std::span<std::unique_ptr<type_checker::Statement> const> const statements)
+                    -> std::string {
+                m_output = prologue;
+                for (auto const& statement : statements) {
+                    transpile_statement(*statement);
+                }
+                m_output += epilogue;
+                return std::move(m_output);
+            }
+
+        private:
+            auto transpile_print_argument(type_checker::Expression const& argument) -> void {
+                if (argument.data_type() == type_checker::string_type) {
+                    auto const literal = dynamic_cast<type_checker::StringLiteral const*>(std::addressof(argument));
+                    if (literal == nullptr) {
+                        throw std::runtime_error{ "Unsupported expression of type String." };
+                    }
+                    auto const text = literal->value();
+                    m_output += std::format("    print_string({}, {});\n", to_cpp_string_literal(text), text.length());
+                } else if (argument.data_type() == type_checker::u64_type) {
+                    m_output += std::format("    print_u64({});\n", transpile_expression(argument));
+                } else {
+                    throw std::runtime_error{ "Unsupported data type for printing." };
+                }
+            }
+
+            auto transpile(type_checker::Print const& statement) -> void {
+                transpile_print_argument(*statement.argument());
+            }
+
+            auto transpile(type_checker::Println const& statement) -> void {
+                transpile_print_argument(*statement.argument());
+                m_output += "    print_newline();\n";
+            }
+
+            [[nodiscard]] auto transpile(type_checker::StringLiteral const&) -> std::string {
+                throw std::runtime_error{ "String literals can only be printed." };
+            }
+
+            [[nodiscard]] auto transpile(type_checker::UnsignedIntegerLiteral const& expression) -> std::string {
+                return std::format("UINT64_C({})", expression.value());
+            }
+
+            // Unsigned arithmetic wraps around in C++ as well, so only division and modulo need a helper.
+            [[nodiscard]] auto transpile(type_checker::BinaryOperator const& expression) -> std::string {
+                auto const lhs = transpile_expression(expression.lhs());
+                auto const rhs = transpile_expression(expression.rhs());
+                switch (expression.operator_type()) {
+                    case lexer::TokenType::Plus:
+                        return std::format("({} + {})", lhs, rhs);
+                    case lexer::TokenType::Minus:
+                        return std::format("({} - {})", lhs, rhs);
+                    case lexer::TokenType::Asterisk:
+                        return std::format("({} * {})", lhs, rhs);
+                    case lexer::TokenType::ForwardSlash:
+                        return std::format("divide({}, {})", lhs, rhs);
+                    case lexer::TokenType::Mod:
+                        return std::format("modulo({}, {})", lhs, rhs);
+                    default:
+                        throw std::runtime_error{ "Unsupported binary operator." };
+                }
+            }
+
+            auto transpile_statement(type_checker::Statement const& statement) -> void {
+                static constexpr auto context = std::meta::access_context::current();
+                template for (constexpr auto member :
+                              std::define_static_array(members_of(^^type_checker, context))) {
+                    if constexpr (is_type(member) and is_class_type(member)) {
+                        static constexpr auto does_inherit_base =
+                                std::ranges::any_of(bases_of(member, context), [](auto const& base) {
+                                    return is_same_type(type_of(base), ^^type_checker::Statement);
+                                });
+                        if constexpr (does_inherit_base) {
+                            auto const downcasted = dynamic_cast<[:member:] const*>(std::addressof(statement));
+                            if (downcasted != nullptr) {
+                                return transpile(*downcasted);
+                            }
+                        }
+                    }
+                }
+                throw std::runtime_error{ "Unreachable" };
+            }
+
+            [[nodiscard]] auto transpile_expression(type_checker::Expression const& expression) -> std::string {
+                static constexpr auto context = std::meta::access_context::current();
+                template for (constexpr auto member :
+                              std::define_static_array(members_of(^^type_checker, context))) {
+                    if constexpr (is_type(member) and is_class_type(member)) {
+                        static constexpr auto does_inherit_base =
+                                std::ranges::any_of(bases_of(member, context), [](auto const& base) {
+                                    return is_same_type(type_of(base), ^^type_checker::Expression);
+                                });
+                        if constexpr (does_inherit_base) {
+                            auto const downcasted = dynamic_cast<[:member:] const*>(std::addressof(expression));
+                            if (downcasted != nullptr) {
+                                return transpile(*downcasted);
+                            }
+                        }
+                    }
+                }
+                throw std::runtime_error{ "Unreachable" };
+            }
+        };
+    } // namespace
+
+    [[nodiscard]] auto transpile(std::span<std::unique_ptr<type_checker::Statement> const> const statements)
+            -> std::string {
+        auto transpiler = Transpiler{};
+        return transpiler.run(statements);
+    }
+
+} // namespace transpiler
@@ -0,0 +1,94 @@
+#include "checking.hpp"
+#include <algorithm>
+#include <experimental/meta>
+#include <type_checker/annotations.hpp>
+
+namespace type_checker {
+
+    namespace {
+        class Annotator final {
+        private:
+            TypeAnnotations m_annotations;
+
+        public:
+            [[nodiscard]] auto run(std::span<std::unique_ptr<parser::Statement> const> const statements)
+                    -> TypeAnnotations {
+                for (auto const& statement : statements) {
+                    annotate_statement(*statement);
+                }
+                return std::move(m_annotations);
+            }
+
+        private:
+            auto annotate(parser::Print const& statement) -> void {
+                check_printable(annotate_expression(statement.argument()));
+            }
+
+            auto annotate(parser::Println const& statement) -> void {
+                check_printable(annotate_expression(statement.argument()));
+            }
+
+            [[nodiscard]] auto annotate(parser::StringLiteral const& expression) -> TypeId {
+                m_annotations.set_string_value(expression.id(), expression.token().source_location().lexeme());
+                return string_type;
+            }
+
+            [[nodiscard]] auto annotate(parser::UnsignedIntegerLiteral const&) -> TypeId {
+                return u64_type;
+            }
+
+            [[nodiscard]] auto annotate(parser::BinaryOperator const& expression) -> TypeId {
+                auto const lhs_type = annotate_expression(expression.lhs());
+                auto const rhs_type = annotate_expression(expression.rhs());
+                return BinaryOperator::get_resulting_data_type(lhs_type, expression.operator_token(), rhs_type);
+            }
+
+            auto annotate_statement(parser::Statement const& statement) -> void {
+                static constexpr auto context = std::meta::access_context::current();
+                template for (constexpr auto member : std::define_static_array(members_of(^^parser, context))) {
+                    if constexpr (is_type(member) and is_class_type(member)) {
+                        static constexpr auto does_inherit_base =
+                                std::ranges::any_of(bases_of(member, context), [](auto const& base) {
+                                    return is_same_type(type_of(base), ^^parser::Statement);
+                                });
+                        if constexpr (does_inherit_base) {
+                            auto const downcasted = dynamic_cast<[:member:] const*>(std::addressof(statement));
+                            if (downcasted != nullptr) {
+                                return annotate(*downcasted);
+                            }
+                        }
+                    }
+                }
+                throw std::runtime_error{ "Unreachable" };
+            }
+
+            [[nodiscard]] auto annotate_expression(parser::Expression const& expression) -> TypeId {
+                static constexpr auto context = std::meta::access_context::current();
+                template for (constexpr auto member : std::define_static_array(members_of(^^parser, context))) {
+                    if constexpr (is_type(member) and is_class_type(member)) {
+                        static constexpr auto does_inherit_base =
+                                std::ranges::any_of(bases_of(member, context), [](auto const& base) {
+                                    return is_same_type(type_of(base), ^^parser::Expression);
+                                });
+                        if constexpr (does_inherit_base) {
+                            auto const downcasted = dynamic_cast<[:member:] const*>(std::addressof(expression));
+                            if (downcasted != nullptr) {
+                                auto const data_type = annotate(*downcasted);
+                                m_annotations.set(expression.id(), data_type);
+                                return data_type;
+                            }
+                        }
+                    }
+                }
+                throw std::runtime_error{ "Unreachable" };
+            }
+        };
+    } // namespace
+
+    [[nodiscard]] auto annotate_types(std::span<std::unique_ptr<parser::Statement> const> const statements)
+            -> TypeAnnotations {
+        auto annotator = Annotator{};
+        return annotator.run(statements);
+    }
+
+} // namespace type_checker
@@ -3,40 +3,58 @@
 #include <algorithm>
 #include <experimental/meta>
 #include <parser/parser.hpp>
+#include <type_checker/expression_pool.hpp>
 #include <type_checker/expressions.hpp>
 #include <type_checker/statements.hpp>
 #include <utility>
 
 namespace type_checker {
 
+    // `Result` is the pointer type that owns the checked node. Typed expressions are interned into `expressions`.
     template<typename BaseType, typename Result>
-    [[nodiscard]] auto check_child_types(BaseType const& value) -> std::unique_ptr<Result>;
+    [[nodiscard]] auto check_child_types(BaseType const& value, ExpressionPool& expressions) -> Result;
 
-    [[nodiscard]] inline auto check_types(parser::StringLiteral const& expression) -> std::unique_ptr<Expression> {
-        return std::make_unique<StringLiteral>(expression.token());
+    inline auto check_printable(TypeId const data_type) -> void {
+        if (data_type != string_type and data_type != u64_type) {
+            throw InvalidTypeError{ "Invalid argument type for printing." };
+        }
+    }
+
+    [[nodiscard]] inline auto check_types(parser::StringLiteral const& expression, ExpressionPool& expressions)
+            -> std::shared_ptr<Expression const> {
+        return expressions.string_literal(expression.token());
     }
 
-    [[nodiscard]] inline auto check_types(parser::UnsignedIntegerLiteral const& expression)
-            -> std::unique_ptr<Expression> {
-        return std::make_unique<UnsignedIntegerLiteral>(expression.token());
+    [[nodiscard]] inline auto check_types(parser::UnsignedIntegerLiteral const& expression, ExpressionPool& expressions)
+            -> std::shared_ptr<Expression const> {
+        return expressions.unsigned_integer_literal(expression.value());
     }
 
-    [[nodiscard]] inline auto check_types(parser::Print const& statement) -> std::unique_ptr<Statement> {
-        return std::make_unique<Print>(statement.argument());
+    [[nodiscard]] inline auto check_types(parser::Print const& statement, ExpressionPool& expressions)
+            -> std::unique_ptr<Statement> {
+        return std::make_unique<Print>(statement.argument(), expressions);
     }
 
-    [[nodiscard]] inline auto check_types(parser::Println const& statement) -> std::unique_ptr<Statement> {
-        return std::make_unique<Println>(statement.argument());
+    [[nodiscard]] inline auto check_types(parser::Println const& statement, ExpressionPool& expressions)
+            -> std::unique_ptr<Statement> {
+        return std::make_unique<Println>(statement.argument(), expressions);
     }
 
-    [[nodiscard]] inline auto check_types(parser::BinaryOperator const& expression) -> std::unique_ptr<Expression> {
-        auto lhs = check_child_types<parser::Expression, Expression>(expression.lhs());
-        auto rhs = check_child_types<parser::Expression, Expression>(expression.rhs());
-        return std::make_unique<BinaryOperator>(std::move(lhs), expression.operator_token(), std::move(rhs));
+    [[nodiscard]] inline auto check_types(parser::BinaryOperator const& expression, ExpressionPool& expressions)
+            -> std::shared_ptr<Expression const> {
+        auto lhs = check_child_types<parser::Expression, std::shared_ptr<Expression const>>(
+                expression.lhs(),
+                expressions
+        );
+        auto rhs = check_child_types<parser::Expression, std::shared_ptr<Expression const>>(
+                expression.rhs(),
+                expressions
+        );
+        return expressions.binary_operator(std::move(lhs), expression.operator_token(), std::move(rhs));
     }
 
     template<typename BaseType, typename Result>
-    [[nodiscard]] auto check_child_types(BaseType const& value) -> std::unique_ptr<Result> {
+    [[nodiscard]] auto check_child_types(BaseType const& value, ExpressionPool& expressions) -> Result {
         static constexpr auto context = std::meta::access_context::current();
         template for (constexpr auto member : std::define_static_array(members_of(^^parser, context))) {
             if constexpr (is_type(member) and is_class_type(member)) {
@@ -47,7 +65,7 @@ namespace type_checker {
                 if constexpr (does_inherit_base) {
                     auto const downcasted = dynamic_cast<[:member:] const*>(std::addressof(value));
                     if (downcasted != nullptr) {
-                        return check_types(*downcasted);
+                        return check_types(*downcasted, expressions);
                     }
                 }
             }
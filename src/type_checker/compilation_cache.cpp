@@ -0,0 +1,102 @@
+#include <lexer/lexer.hpp>
+#include <parser/parser.hpp>
+#include <span>
+#include <string_view>
+#include <type_checker/compilation_cache.hpp>
+#include <type_checker/type_checker.hpp>
+#include <unordered_set>
+
+namespace type_checker {
+
+    namespace {
+        // Owns the typed statements of one top-level token slice.
+        struct Fragment final {
+            std::vector<std::unique_ptr<Statement>> statements;
+        };
+
+        [[nodiscard]] auto slice_key(std::span<lexer::Token const> const tokens) -> std::string {
+            auto key = std::string{};
+            for (auto const& token : tokens) {
+                auto const lexeme = token.source_location().lexeme();
+                key += std::to_string(lexeme.length());
+                key += ':';
+                key += lexeme;
+            }
+            return key;
+        }
+
+        struct PendingSlice final {
+            std::string key;
+            std::vector<std::unique_ptr<parser::Statement>> parse_tree;
+        };
+    } // namespace
+
+    [[nodiscard]] auto CompilationCache::compile(std::string_view const filename, std::string_view const contents)
+            -> std::vector<std::shared_ptr<Statement const>> {
+        auto const tokens = lexer::tokenize(filename, contents);
+
+        // Every top-level statement ends with a semicolon, so the token stream can be split into the slices of
+        // the individual statements without parsing it. The stream always ends with an `EndOfFile` token.
+        auto slices = std::vector<std::span<lexer::Token const>>{};
+        auto const end_of_file_index = tokens.size() - 1;
+        auto slice_begin = 0uz;
+        for (auto i = 0uz; i < end_of_file_index; ++i) {
+            if (tokens.at(i).type() == lexer::TokenType::Semicolon or i + 1 == end_of_file_index) {
+                slices.push_back(std::span{ tokens }.subspan(slice_begin, i + 1 - slice_begin));
+                slice_begin = i + 1;
+            }
+        }
+
+        auto keys = std::vector<std::string>{};
+        keys.reserve(slices.size());
+        for (auto const& slice : slices) {
+            keys.push_back(slice_key(slice));
+        }
+
+        // All new slices are parsed before any of them is type-checked. This way, the reported error is the same
+        // as when compiling the whole source at once.
+        auto pending_slices = std::vector<PendingSlice>{};
+        auto pending_keys = std::unordered_set<std::string_view>{};
+        for (auto i = 0uz; i < slices.size(); ++i) {
+            if (m_entries.contains(keys.at(i)) or pending_keys.contains(keys.at(i))) {
+                continue;
+            }
+            pending_keys.insert(keys.at(i));
+            auto slice_tokens = std::vector<lexer::Token>{ slices.at(i).begin(), slices.at(i).end() };
+            slice_tokens.push_back(tokens.back());
+            pending_slices.push_back(PendingSlice{ keys.at(i), parser::parse(slice_tokens) });
+        }
+
+        auto entries = std::unordered_map<std::string, std::vector<std::shared_ptr<Statement const>>>{};
+        for (auto& [key, parse_tree] : pending_slices) {
+            auto const fragment = std::make_shared<Fragment>(check_types(std::move(parse_tree), m_expressions));
+            auto statements = std::vector<std::shared_ptr<Statement const>>{};
+            for (auto const& statement : fragment->statements) {
+                // The aliasing constructor makes every statement keep its whole fragment alive.
+                statements.emplace_back(fragment, statement.get());
+            }
+            entries.insert_or_assign(std::move(key), std::move(statements));
+        }
+
+        auto program = std::vector<std::shared_ptr<Statement const>>{};
+        m_num_reused_statements = 0;
+        for (auto& key : keys) {
+            // A slice that occurs several times counts once per occurrence.
+            auto const is_reused = not pending_keys.contains(key);
+            auto entry = entries.find(key);
+            if (entry == entries.end()) {
+                auto const cached = m_entries.find(key);
+                entry = entries.insert({ std::move(key), cached->second }).first;
+            }
+            if (is_reused) {
+                m_num_reused_statements += entry->second.size();
+            }
+            program.insert(program.end(), entry->second.begin(), entry->second.end());
+        }
+
+        // Entries that are not part of the latest compilation are dropped.
+        m_entries = std::move(entries);
+        return program;
+    }
+
+} // namespace type_checker
@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <type_checker/expression_pool.hpp>
+#include <utility>
+
+namespace type_checker {
+
+    [[nodiscard]] auto ExpressionPool::KeyHash::operator()(Key const& key) const -> usize {
+        auto result = std::hash<std::string>{}(key.lexeme);
+        auto const combine = [&result](usize const hash) {
+            result ^= hash + 0x9E37'79B9'7F4A'7C15 + (result << 6) + (result >> 2);
+        };
+        combine(std::to_underlying(key.kind));
+        combine(std::hash<std::uint64_t>{}(key.value));
+        combine(static_cast<usize>(std::to_underlying(key.operator_type)));
+        combine(std::hash<Expression const*>{}(key.lhs));
+        combine(std::hash<Expression const*>{}(key.rhs));
+        return result;
+    }
+
+    [[nodiscard]] auto ExpressionPool::string_literal(lexer::Token const& token) -> std::shared_ptr<Expression const> {
+        auto key = Key{ Kind::StringLiteral, std::string{ token.source_location().lexeme() } };
+        return intern(std::move(key), [&](ExpressionId const id) {
+            return std::make_shared<StringLiteral>(id, token);
+        });
+    }
+
+    [[nodiscard]] auto ExpressionPool::unsigned_integer_literal(std::uint64_t const value)
+            -> std::shared_ptr<Expression const> {
+        auto key = Key{ Kind::UnsignedIntegerLiteral, {}, value };
+        return intern(std::move(key), [&](ExpressionId const id) {
+            return std::make_shared<UnsignedIntegerLiteral>(id, value);
+        });
+    }
+
+    [[nodiscard]] auto ExpressionPool::binary_operator(
+            std::shared_ptr<Expression const> lhs,
+            lexer::Token const& operator_token,
+            std::shared_ptr<Expression const> rhs
+    ) -> std::shared_ptr<Expression const> {
+        auto key = Key{ Kind::BinaryOperator, {}, 0, operator_token.type(), lhs.get(), rhs.get() };
+        return intern(std::move(key), [&](ExpressionId const id) {
+            return std::make_shared<BinaryOperator>(id, std::move(lhs), operator_token, std::move(rhs));
+        });
+    }
+
+    [[nodiscard]] auto ExpressionPool::id_limit() -> ExpressionId {
+        auto const lock = std::scoped_lock{ m_mutex };
+        return m_next_id;
+    }
+
+    template<typename Create>
+    [[nodiscard]] auto ExpressionPool::intern(Key key, Create const& create) -> std::shared_ptr<Expression const> {
+        auto const lock = std::scoped_lock{ m_mutex };
+        auto const it = m_entries.find(key);
+        if (it != m_entries.end()) {
+            if (auto existing = it->second.node.lock()) {
+                return existing;
+            }
+            // The node has been destroyed, so its id can be given to the node that replaces it.
+            auto created = std::shared_ptr<Expression const>{ create(it->second.id) };
+            it->second.node = created;
+            return created;
+        }
+
+        // Nodes are owned by the statements that use them. A pool that outlives them (e.g. the one of a
+        // `CompilationCache`) removes the entries of destroyed nodes once the table has doubled in size and
+        // recycles their ids.
+        if (m_entries.size() >= m_sweep_threshold) {
+            std::erase_if(m_entries, [this](auto const& entry) {
+                if (not entry.second.node.expired()) {
+                    return false;
+                }
+                m_free_ids.push_back(entry.second.id);
+                return true;
+            });
+            m_sweep_threshold = std::max(m_sweep_threshold, 2 * m_entries.size());
+        }
+
+        if (m_free_ids.empty() and m_next_id == std::numeric_limits<ExpressionId>::max()) {
+            throw std::overflow_error{ "Too many distinct expressions." };
+        }
+        // The id is only taken once the node has been created, since creating it can fail with a type error.
+        auto const id = m_free_ids.empty() ? m_next_id : m_free_ids.back();
+        auto created = std::shared_ptr<Expression const>{ create(id) };
+        if (m_free_ids.empty()) {
+            ++m_next_id;
+        } else {
+            m_free_ids.pop_back();
+        }
+        m_entries.emplace(std::move(key), Entry{ created, id });
+        return created;
+    }
+
+} // namespace type_checker
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "data_type.hpp"
+#include "string_table.hpp"
+#include <limits>
+#include <memory>
+#include <parser/parser.hpp>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace type_checker {
+    // Side table that maps the expression nodes of a parse tree (by their `parser::NodeId`) to their data types.
+    // This allows running a type-checked program without building a second, typed tree. It also owns the decoded
+    // contents of the string literals of the tree.
+    class TypeAnnotations final {
+    private:
+        std::vector<TypeId> m_data_types;
+        StringTable m_string_table;
+        // Indexed by the `parser::NodeId` of a string literal.
+        std::vector<std::string_view> m_string_values;
+
+    public:
+        auto set(parser::NodeId const id, TypeId const data_type) -> void {
+            if (id >= m_data_types.size()) {
+                m_data_types.resize(id + 1uz, TypeId{ std::numeric_limits<std::uint32_t>::max() });
+            }
+            m_data_types[id] = data_type;
+        }
+
+        [[nodiscard]] auto operator[](parser::NodeId const id) const -> TypeId {
+            return m_data_types.at(id);
+        }
+
+        auto set_string_value(parser::NodeId const id, std::string_view const lexeme) -> void {
+            if (id >= m_string_values.size()) {
+                m_string_values.resize(id + 1uz);
+            }
+            m_string_values[id] = m_string_table.intern_literal(lexeme);
+        }
+
+        // The decoded contents of a string literal. Valid for the lifetime of the annotations.
+        [[nodiscard]] auto string_value(parser::NodeId const id) const -> std::string_view {
+            return m_string_values.at(id);
+        }
+    };
+
+    [[nodiscard]] auto annotate_types(std::span<std::unique_ptr<parser::Statement> const> statements)
+            -> TypeAnnotations;
+} // namespace type_checker
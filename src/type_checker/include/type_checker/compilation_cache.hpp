@@ -0,0 +1,37 @@
+#pragma once
+
+#include "expression_pool.hpp"
+#include "statements.hpp"
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utils/types.hpp>
+#include <vector>
+
+namespace type_checker {
+    // Remembers the typed statements of the previous compilation, keyed by the contents of their tokens. When
+    // recompiling an edited source, only the statements whose tokens have changed are parsed and type-checked
+    // again. All other statements are shared with the previous result. Typed statements don't carry source
+    // locations, so a statement can be reused after it has moved to a different line. Errors can only be reported
+    // for slices that are compiled again, and their locations refer to the current source.
+    //
+    // All compilations of one cache intern into the same `ExpressionPool`, so that reused and new statements have
+    // distinct expression ids within the combined program.
+    class CompilationCache final {
+    private:
+        ExpressionPool m_expressions;
+        std::unordered_map<std::string, std::vector<std::shared_ptr<Statement const>>> m_entries;
+        usize m_num_reused_statements{ 0 };
+
+    public:
+        // The returned statements don't refer to the source, so it doesn't have to outlive them.
+        [[nodiscard]] auto compile(std::string_view filename, std::string_view contents)
+                -> std::vector<std::shared_ptr<Statement const>>;
+
+        // Number of top-level statements that have been taken from the cache during the last compilation.
+        [[nodiscard]] auto num_reused_statements() const -> usize {
+            return m_num_reused_statements;
+        }
+    };
+} // namespace type_checker
@@ -1,36 +1,68 @@
 #pragma once
 
+#include <cstdint>
+#include <experimental/meta>
 #include <tl/optional.hpp>
+#include <utility>
 
 namespace type_checker {
+    // The kernel table of `BinaryOperator` and the interpreter's kernels are derived from this enumeration. A new
+    // data type still needs these manual steps, and the build fails until they are done:
+    //  1. The operand types it accepts in `BinaryOperator::get_resulting_data_type()` (and `check_printable()`).
+    //  2. Its C++ representation in `interpreter::representation_of()`.
+    //  3. If that representation is new: storage for it in `interpreter::Value` (a factory and a branch in
+    //     `Value::get()`), and `interpreter::apply_binary_operator()` overloads for the accepted operand types.
+    //  4. The engines that switch over the data types (bytecode, JIT, closures, IR lowering, transpiler).
     enum class BuiltinDataType {
         String,
         U64,
     };
 
-    class DataType {
-    public:
-        [[nodiscard]] DataType() = default;
-        DataType(DataType const& other) = delete;
-        DataType(DataType&& other) noexcept = default;
-        DataType& operator=(DataType const& other) = delete;
-        DataType& operator=(DataType&& other) noexcept = default;
-        virtual ~DataType() = default;
-
-        [[nodiscard]] virtual auto as_builtin_type() const -> tl::optional<BuiltinDataType> = 0;
-        [[nodiscard]] static auto from_builtin_type(BuiltinDataType type) -> std::unique_ptr<DataType>;
-    };
+    inline constexpr auto num_builtin_data_types =
+            static_cast<std::uint32_t>(enumerators_of(dealias(^^BuiltinDataType)).size());
+
+    // Compact handle to a data type. The ids of the builtin data types equal the enumerator values of
+    // `BuiltinDataType`. Since there are no other data types yet, no table is needed to resolve an id.
+    class TypeId final {
+    private:
+        std::uint32_t m_value;
 
-    class String final : public DataType {
     public:
-        [[nodiscard]] auto as_builtin_type() const -> tl::optional<BuiltinDataType> override {
-            return BuiltinDataType::String;
+        [[nodiscard]] constexpr explicit TypeId(std::uint32_t const value) : m_value{ value } { }
+
+        [[nodiscard]] static constexpr auto from_builtin_type(BuiltinDataType const type) -> TypeId {
+            return TypeId{ static_cast<std::uint32_t>(std::to_underlying(type)) };
+        }
+
+        [[nodiscard]] constexpr auto value() const -> std::uint32_t {
+            return m_value;
+        }
+
+        [[nodiscard]] constexpr auto as_builtin_type() const -> tl::optional<BuiltinDataType> {
+            if (m_value >= num_builtin_data_types) {
+                return tl::nullopt;
+            }
+            return static_cast<BuiltinDataType>(m_value);
         }
+
+        [[nodiscard]] constexpr auto operator==(TypeId const& other) const -> bool = default;
     };
 
-    class U64 final : public DataType {
-        [[nodiscard]] auto as_builtin_type() const -> tl::optional<BuiltinDataType> override {
-            return BuiltinDataType::U64;
+    inline constexpr auto string_type = TypeId::from_builtin_type(BuiltinDataType::String);
+    inline constexpr auto u64_type = TypeId::from_builtin_type(BuiltinDataType::U64);
+
+    class DataType final {
+    private:
+        tl::optional<BuiltinDataType> m_builtin_type;
+
+    public:
+        [[nodiscard]] constexpr explicit DataType(BuiltinDataType const builtin_type)
+            : m_builtin_type{ builtin_type } { }
+
+        [[nodiscard]] constexpr auto as_builtin_type() const -> tl::optional<BuiltinDataType> {
+            return m_builtin_type;
         }
+
+        [[nodiscard]] constexpr auto operator==(DataType const& other) const -> bool = default;
     };
-}
+} // namespace type_checker
@@ -1,10 +1,24 @@
 #pragma once
 
+#include <lexer/source_location.hpp>
 #include <stdexcept>
+#include <tl/optional.hpp>
 
 namespace type_checker {
     class InvalidTypeError : public std::invalid_argument {
+    private:
+        tl::optional<lexer::SourceLocation> m_source_location;
+
     public:
         [[nodiscard]] explicit InvalidTypeError(std::string const& msg) : std::invalid_argument{ msg } { }
+
+        [[nodiscard]] explicit InvalidTypeError(std::string const& msg, lexer::SourceLocation const& source_location)
+            : std::invalid_argument{ msg },
+              m_source_location{ source_location } { }
+
+        // The location of the offending token, if there is one.
+        [[nodiscard]] auto source_location() const -> tl::optional<lexer::SourceLocation> const& {
+            return m_source_location;
+        }
     };
 }
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "expressions.hpp"
+#include <cstdint>
+#include <lexer/token.hpp>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utils/types.hpp>
+#include <vector>
+
+namespace type_checker {
+
+    // Hash-conses typed expressions: creating an expression that is structurally identical to a living one
+    // returns the existing node instead. Since children are interned before their parents, two binary operators
+    // are identical iff their operators match and their children are the same nodes. Nodes don't refer to the
+    // tokens they have been created from, so a pool can outlive the sources of its nodes.
+    //
+    // Usually every compilation uses its own pool, so nodes are only shared within one program and the ids of a
+    // program are dense, starting at zero. A pool can also outlive many programs (e.g. the one of a
+    // `CompilationCache`). The ids of destroyed nodes are handed out again, so ids stay below roughly twice the
+    // number of living nodes instead of growing with every compilation, but they are no longer dense. Interning is
+    // thread-safe, so that the statements of one program can be checked in parallel.
+    class ExpressionPool final {
+    private:
+        enum class Kind : std::uint8_t {
+            StringLiteral,
+            UnsignedIntegerLiteral,
+            BinaryOperator,
+        };
+
+        struct Key final {
+            Kind kind;
+            std::string lexeme;               // Only used for string literals.
+            std::uint64_t value{ 0 };         // Only used for unsigned integer literals.
+            lexer::TokenType operator_type{}; // Only used for binary operators.
+            Expression const* lhs{ nullptr };
+            Expression const* rhs{ nullptr };
+
+            [[nodiscard]] auto operator==(Key const& other) const -> bool = default;
+        };
+
+        struct KeyHash final {
+            [[nodiscard]] auto operator()(Key const& key) const -> usize;
+        };
+
+        struct Entry final {
+            std::weak_ptr<Expression const> node;
+            ExpressionId id; // Still known after the node has been destroyed, so that it can be reused.
+        };
+
+        std::mutex m_mutex;
+        std::unordered_map<Key, Entry, KeyHash> m_entries;
+        ExpressionId m_next_id{ 0 };
+        std::vector<ExpressionId> m_free_ids;
+        usize m_sweep_threshold{ 1024 };
+
+    public:
+        [[nodiscard]] auto string_literal(lexer::Token const& token) -> std::shared_ptr<Expression const>;
+        // The value has already been decoded by the parser.
+        [[nodiscard]] auto unsigned_integer_literal(std::uint64_t value) -> std::shared_ptr<Expression const>;
+        [[nodiscard]] auto binary_operator(
+                std::shared_ptr<Expression const> lhs,
+                lexer::Token const& operator_token,
+                std::shared_ptr<Expression const> rhs
+        ) -> std::shared_ptr<Expression const>;
+
+        // All ids that have been handed out by this pool are less than this value. Can be used to size side tables.
+        [[nodiscard]] auto id_limit() -> ExpressionId;
+
+    private:
+        template<typename Create>
+        [[nodiscard]] auto intern(Key key, Create const& create) -> std::shared_ptr<Expression const>;
+    };
+
+} // namespace type_checker
@@ -2,142 +2,158 @@
 
 #include "data_type.hpp"
 #include "errors.hpp"
+#include "literals.hpp"
 #include <algorithm>
-#include <charconv>
+#include <array>
+#include <cstdint>
+#include <iterator>
 #include <lexer/token.hpp>
 #include <memory>
+#include <string>
+#include <string_view>
 #include <utils/enum_to_string.hpp>
 
 namespace type_checker {
     class StringLiteral;
 
+    // Identifies a (hash-consed) typed expression. Structurally identical expressions share one node and
+    // therefore one id, see `ExpressionPool`.
+    using ExpressionId = std::uint32_t;
+
     class Expression {
     private:
-        std::unique_ptr<DataType> m_data_type;
+        ExpressionId m_id;
+        TypeId m_data_type;
 
     public:
-        [[nodiscard]] explicit Expression(std::unique_ptr<DataType> data_type) : m_data_type{ std::move(data_type) } { }
+        [[nodiscard]] explicit Expression(ExpressionId const id, TypeId const data_type)
+            : m_id{ id },
+              m_data_type{ data_type } { }
         Expression(Expression const& other) = delete;
         Expression(Expression&& other) noexcept = default;
         Expression& operator=(Expression const& other) = delete;
         Expression& operator=(Expression&& other) noexcept = default;
         virtual ~Expression() = default;
 
-        [[nodiscard]] auto data_type() const -> DataType const& {
-            return *m_data_type;
+        [[nodiscard]] auto id() const -> ExpressionId {
+            return m_id;
+        }
+
+        [[nodiscard]] auto data_type() const -> TypeId {
+            return m_data_type;
         }
     };
 
+    // Typed nodes don't keep any tokens, so they stay valid after the source has been destroyed.
     class StringLiteral final : public Expression {
     private:
-        lexer::Token m_token;
+        std::string m_value;
 
     public:
-        [[nodiscard]] explicit StringLiteral(lexer::Token const& token)
-            : Expression{ std::make_unique<String>() },
-              m_token{ token } { }
-
-        [[nodiscard]] auto to_escaped_string() const -> std::string {
-            static constexpr auto escape_characters = std::array{
-                std::pair{  'n', '\n' },
-                std::pair{  't', '\t' },
-                std::pair{  'f', '\f' },
-                std::pair{  'r', '\r' },
-                std::pair{ '\\', '\\' },
-                std::pair{  '"',  '"' },
-            };
-            auto const inside_quotes =
-                    m_token.source_location().lexeme().substr(1, m_token.source_location().length() - 2);
-            auto result = std::string{};
-            result.reserve(inside_quotes.length());
-
-            auto i = 0u;
-            while (i < inside_quotes.length() - 1) {
-                auto const first = inside_quotes.at(i);
-                auto const second = inside_quotes.at(i + 1);
-                if (first != '\\') {
-                    result += first;
-                    ++i;
-                    continue;
-                }
-                auto const pair =
-                        std::ranges::find_if(escape_characters, [second](auto const& p) { return p.first == second; });
-                if (pair == escape_characters.end()) {
-                    throw std::runtime_error{ "Invalid string literal (lexer bug?)." };
-                }
-                result += pair->second;
-                i += 2;
-            }
-
-            // Append last character if not already appended.
-            if (i < inside_quotes.length()) {
-                result += inside_quotes.at(i);
-            }
-
-            return result;
+        [[nodiscard]] explicit StringLiteral(ExpressionId const id, lexer::Token const& token)
+            : Expression{ id, string_type },
+              m_value{ decode_string_literal(token.source_location().lexeme()) } { }
+
+        // The decoded contents. Since the node is hash-consed, every distinct literal of a program is decoded
+        // once, and runtime string values can refer to the node's copy for as long as the program is alive.
+        [[nodiscard]] auto value() const -> std::string_view {
+            return m_value;
         }
     };
 
     class UnsignedIntegerLiteral final : public Expression {
     private:
-        lexer::Token m_token;
+        std::uint64_t m_value;
 
     public:
-        [[nodiscard]] explicit UnsignedIntegerLiteral(lexer::Token const& token)
-            : Expression{ std::make_unique<U64>() },
-              m_token{ token } { }
+        [[nodiscard]] explicit UnsignedIntegerLiteral(ExpressionId const id, std::uint64_t const value)
+            : Expression{ id, u64_type },
+              m_value{ value } { }
 
         [[nodiscard]] auto value() const -> std::uint64_t {
-            static constexpr auto suffix_length = std::string_view{ "_u64" }.length();
-            auto const without_suffix =
-                    m_token.source_location().lexeme().substr(0, m_token.source_location().length() - suffix_length);
-            static constexpr auto thousands_separator = '\'';
-            auto without_separators = std::string{};
-            std::copy_if(
-                    without_suffix.begin(),
-                    without_suffix.end(),
-                    std::back_inserter(without_separators),
-                    [](char const c) { return c != thousands_separator; }
-            );
-            auto value = std::uint64_t{};
-            auto const [_, ec] =
-                    std::from_chars(without_separators.data(), without_separators.data() + without_separators.length(), value);
-            if (ec != std::errc{}) {
-                throw std::runtime_error{ "Invalid unsigned integer literal (lexer bug?)." };
-            }
-            return value;
+            return m_value;
         }
     };
 
+    // Identifies the combination of operator and operand types of a `BinaryOperator`. Backends use it to index
+    // tables of operations that are specialized for exactly these operand types.
+    using KernelId = std::uint32_t;
+
     class BinaryOperator final : public Expression {
     private:
-        std::unique_ptr<Expression> m_lhs;
-        lexer::Token m_operator_token;
-        std::unique_ptr<Expression> m_rhs;
+        std::shared_ptr<Expression const> m_lhs;
+        lexer::TokenType m_operator_type;
+        std::shared_ptr<Expression const> m_rhs;
+        KernelId m_kernel;
 
     public:
+        static constexpr auto operator_token_types = std::array{
+            lexer::TokenType::Plus,         lexer::TokenType::Minus, lexer::TokenType::Asterisk,
+            lexer::TokenType::ForwardSlash, lexer::TokenType::Mod,
+        };
+
+        static constexpr auto num_kernels =
+                static_cast<KernelId>(operator_token_types.size() * num_builtin_data_types * num_builtin_data_types);
+
         [[nodiscard]] explicit BinaryOperator(
-                std::unique_ptr<Expression> lhs,
+                ExpressionId const id,
+                std::shared_ptr<Expression const> lhs,
                 lexer::Token const& operator_token,
-                std::unique_ptr<Expression> rhs
+                std::shared_ptr<Expression const> rhs
         )
-            : Expression{ get_resulting_data_type(*lhs, operator_token, *rhs) },
+            : Expression{ id, get_resulting_data_type(lhs->data_type(), operator_token, rhs->data_type()) },
               m_lhs{ std::move(lhs) },
-              m_operator_token{ operator_token },
-              m_rhs{ std::move(rhs) } { }
+              m_operator_type{ operator_token.type() },
+              m_rhs{ std::move(rhs) },
+              m_kernel{ get_kernel(m_lhs->data_type(), operator_token.type(), m_rhs->data_type()) } { }
 
         [[nodiscard]] auto lhs() const -> Expression const& {
             return *m_lhs;
         }
 
-        [[nodiscard]] auto operator_token() const -> lexer::Token const& {
-            return m_operator_token;
+        [[nodiscard]] auto operator_type() const -> lexer::TokenType {
+            return m_operator_type;
         }
 
         [[nodiscard]] auto rhs() const -> Expression const& {
             return *m_rhs;
         }
 
+        // Resolved once during type checking, so that backends don't have to inspect the operand types again.
+        [[nodiscard]] auto kernel() const -> KernelId {
+            return m_kernel;
+        }
+
+        [[nodiscard]] static constexpr auto get_kernel(
+                usize const operator_index,
+                BuiltinDataType const lhs_type,
+                BuiltinDataType const rhs_type
+        ) -> KernelId {
+            auto const lhs_index = static_cast<usize>(lhs_type);
+            auto const rhs_index = static_cast<usize>(rhs_type);
+            return static_cast<KernelId>(
+                    (operator_index * num_builtin_data_types + lhs_index) * num_builtin_data_types + rhs_index
+            );
+        }
+
+        // The operand types must have been checked with `get_resulting_data_type()` before.
+        [[nodiscard]] static auto
+        get_kernel(TypeId const lhs_type, lexer::TokenType const operator_token_type, TypeId const rhs_type)
+                -> KernelId {
+            auto const operator_index = static_cast<usize>(std::distance(
+                    operator_token_types.begin(),
+                    std::ranges::find(operator_token_types, operator_token_type)
+            ));
+            return get_kernel(operator_index, lhs_type.as_builtin_type().value(), rhs_type.as_builtin_type().value());
+        }
+
+        // The data type of the result of a kernel, or `tl::nullopt` if the operand types are invalid for the operator.
+        [[nodiscard]] static constexpr auto get_resulting_data_type(KernelId const kernel)
+                -> tl::optional<BuiltinDataType> {
+            static constexpr auto table = get_data_type_table();
+            return table[kernel];
+        }
+
     private:
         [[nodiscard]] static consteval auto get_resulting_data_type(
                 BuiltinDataType const lhs_type,
@@ -159,82 +175,72 @@ namespace type_checker {
             }
         }
 
-        [[nodiscard]] static consteval auto get_data_type_matrix(lexer::TokenType const operator_token_type) {
-            static constexpr auto num_data_types = enumerators_of(dealias(^^BuiltinDataType)).size();
-            auto matrix = std::array<std::array<tl::optional<BuiltinDataType>, num_data_types>, num_data_types>{};
-            auto lhs_index = 0uz;
-            template for (constexpr auto lhs_type :
-                          std::define_static_array(enumerators_of(dealias(^^BuiltinDataType)))) {
-                auto rhs_index = 0uz;
-                template for (constexpr auto rhs_type :
+        // Indexed by `KernelId`.
+        [[nodiscard]] static consteval auto get_data_type_table() {
+            auto table = std::array<tl::optional<BuiltinDataType>, num_kernels>{};
+            for (auto operator_index = 0uz; operator_index < operator_token_types.size(); ++operator_index) {
+                auto lhs_index = 0uz;
+                template for (constexpr auto lhs_type :
                               std::define_static_array(enumerators_of(dealias(^^BuiltinDataType)))) {
-                    if (std::to_underlying([:lhs_type:]) != lhs_index
-                        or std::to_underlying([:rhs_type:]) != rhs_index) {
-                        throw std::runtime_error{ "Inconsistent data type enumeration." };
+                    auto rhs_index = 0uz;
+                    template for (constexpr auto rhs_type :
+                                  std::define_static_array(enumerators_of(dealias(^^BuiltinDataType)))) {
+                        if (std::to_underlying([:lhs_type:]) != lhs_index
+                            or std::to_underlying([:rhs_type:]) != rhs_index) {
+                            throw std::runtime_error{ "Inconsistent data type enumeration." };
+                        }
+                        table[get_kernel(operator_index, [:lhs_type:], [:rhs_type:])] = get_resulting_data_type(
+                                [:lhs_type:],
+                                operator_token_types[operator_index],
+                                [:rhs_type:]
+                        );
+                        ++rhs_index;
                     }
-                    matrix[lhs_index][rhs_index] =
-                            get_resulting_data_type([:lhs_type:], operator_token_type, [:rhs_type:]);
-                    ++rhs_index;
+                    ++lhs_index;
                 }
-                ++lhs_index;
             }
-            return matrix;
+            return table;
         }
 
+    public:
         [[nodiscard]] static auto
-        get_resulting_data_type(Expression const& lhs, lexer::Token const& operator_token, Expression const& rhs)
-                -> std::unique_ptr<DataType> {
-            auto const lhs_builtin_type = lhs.data_type().as_builtin_type();
-            auto const rhs_builtin_type = rhs.data_type().as_builtin_type();
+        get_resulting_data_type(TypeId const lhs_type, lexer::Token const& operator_token, TypeId const rhs_type)
+                -> TypeId {
+            auto const lhs_builtin_type = lhs_type.as_builtin_type();
+            auto const rhs_builtin_type = rhs_type.as_builtin_type();
 
             if (not lhs_builtin_type.has_value()) {
-                throw InvalidTypeError{ "Left-hand side of binary operator has invalid type." };
+                throw InvalidTypeError{
+                    "Left-hand side of binary operator has invalid type.",
+                    operator_token.source_location(),
+                };
             }
             if (not rhs_builtin_type.has_value()) {
-                throw InvalidTypeError{ "Right-hand side of binary operator has invalid type." };
+                throw InvalidTypeError{
+                    "Right-hand side of binary operator has invalid type.",
+                    operator_token.source_location(),
+                };
             }
-
-            static constexpr auto plus_matrix = get_data_type_matrix(lexer::TokenType::Plus);
-            static constexpr auto minus_matrix = get_data_type_matrix(lexer::TokenType::Minus);
-            static constexpr auto asterisk_matrix = get_data_type_matrix(lexer::TokenType::Asterisk);
-            static constexpr auto forward_slash_matrix = get_data_type_matrix(lexer::TokenType::ForwardSlash);
-            static constexpr auto mod_matrix = get_data_type_matrix(lexer::TokenType::Mod);
-
-            auto result_type = tl::optional<BuiltinDataType>{};
-
-            auto const lhs_index = static_cast<usize>(lhs_builtin_type.value());
-            auto const rhs_index = static_cast<usize>(rhs_builtin_type.value());
-
-            switch (operator_token.type()) {
-                case lexer::TokenType::Plus:
-                    result_type = plus_matrix[lhs_index][rhs_index];
-                    break;
-                case lexer::TokenType::Minus:
-                    result_type = minus_matrix[lhs_index][rhs_index];
-                    break;
-                case lexer::TokenType::Asterisk:
-                    result_type = asterisk_matrix[lhs_index][rhs_index];
-                    break;
-                case lexer::TokenType::ForwardSlash:
-                    result_type = forward_slash_matrix[lhs_index][rhs_index];
-                    break;
-                case lexer::TokenType::Mod:
-                    result_type = mod_matrix[lhs_index][rhs_index];
-                    break;
-                default:
-                    throw std::runtime_error{ "Unsupported binary operator." };
+            if (std::ranges::find(operator_token_types, operator_token.type()) == operator_token_types.end()) {
+                throw std::runtime_error{ "Unsupported binary operator." };
             }
 
+            auto const result_type =
+                    get_resulting_data_type(get_kernel(lhs_type, operator_token.type(), rhs_type));
+
             if (not result_type.has_value()) {
-                throw InvalidTypeError{ std::format(
-                        "Invalid operand types '{}' and '{}' for operator '{}'.",
-                        utils::enum_to_string(lhs_builtin_type.value()),
-                        utils::enum_to_string(rhs_builtin_type.value()),
-                        operator_token.source_location().lexeme()
-                ) };
+                throw InvalidTypeError{
+                    std::format(
+                            "Invalid operand types '{}' and '{}' for operator '{}'.",
+                            utils::enum_to_string(lhs_builtin_type.value()),
+                            utils::enum_to_string(rhs_builtin_type.value()),
+                            operator_token.source_location().lexeme()
+                    ),
+                    operator_token.source_location(),
+                };
             }
 
-            return DataType::from_builtin_type(result_type.value());
+            return TypeId::from_builtin_type(result_type.value());
         }
     };
 } // namespace type_checker
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utils/digits.hpp>
+#include <utils/swar.hpp>
+
+namespace type_checker {
+
+    [[nodiscard]] constexpr auto decode_escape_character(char const c) -> char {
+        switch (c) {
+            case 'n':
+                return '\n';
+            case 't':
+                return '\t';
+            case 'f':
+                return '\f';
+            case 'r':
+                return '\r';
+            case '\\':
+            case '"':
+                return c;
+            default:
+                throw std::runtime_error{ "Invalid string literal (lexer bug?)." };
+        }
+    }
+
+    // Decodes the lexeme of a string literal (including the surrounding quotes) by replacing all escape sequences.
+    // The runs between backslashes are found with `utils::find_byte()` and copied in bulk.
+    // Usable at compile time, see `embedded::compile()`.
+    [[nodiscard]] constexpr auto decode_string_literal(std::string_view const lexeme) -> std::string {
+        auto const inside_quotes = lexeme.substr(1, lexeme.length() - 2);
+        auto result = std::string{};
+        result.reserve(inside_quotes.length());
+
+        auto i = 0uz;
+        while (i < inside_quotes.length()) {
+            auto const backslash = i + utils::find_byte(inside_quotes.substr(i), '\\');
+            result.append(inside_quotes.substr(i, backslash - i));
+            if (backslash == inside_quotes.length()) {
+                break;
+            }
+            if (backslash + 1 == inside_quotes.length()) {
+                throw std::runtime_error{ "Invalid string literal (lexer bug?)." };
+            }
+            result += decode_escape_character(inside_quotes[backslash + 1]);
+            i = backslash + 2;
+        }
+
+        return result;
+    }
+
+    // Decodes the lexeme of an unsigned integer literal (including the type suffix and thousands separators).
+    // Usable at compile time, see `embedded::compile()`.
+    [[nodiscard]] constexpr auto decode_unsigned_integer_literal(std::string_view const lexeme) -> std::uint64_t {
+        static constexpr auto suffix_length = std::string_view{ "_u64" }.length();
+        static constexpr auto thousands_separator = '\'';
+        auto const value = utils::parse_decimal(lexeme.substr(0, lexeme.length() - suffix_length), thousands_separator);
+        if (not value.has_value()) {
+            switch (value.error()) {
+                case utils::DecimalParseError::InvalidDigit:
+                    throw std::runtime_error{ "Invalid unsigned integer literal (lexer bug?)." };
+                case utils::DecimalParseError::OutOfRange:
+                    throw std::runtime_error{ "Unsigned integer literal is out of range." };
+            }
+        }
+        return value.value();
+    }
+
+} // namespace type_checker
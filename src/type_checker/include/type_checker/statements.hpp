@@ -1,5 +1,6 @@
 #pragma once
 
+#include "expression_pool.hpp"
 #include "expressions.hpp"
 #include <parser/parser.hpp>
 #include <memory>
@@ -17,24 +18,24 @@ namespace type_checker {
 
     class Print final : public Statement {
     private:
-        std::unique_ptr<Expression> m_argument;
+        std::shared_ptr<Expression const> m_argument;
 
     public:
-        [[nodiscard]] explicit Print(parser::Expression const& argument);
+        [[nodiscard]] explicit Print(parser::Expression const& argument, ExpressionPool& expressions);
 
-        [[nodiscard]] auto argument() const -> std::unique_ptr<Expression> const& {
+        [[nodiscard]] auto argument() const -> std::shared_ptr<Expression const> const& {
             return m_argument;
         }
     };
 
     class Println final : public Statement {
     private:
-        std::unique_ptr<Expression> m_argument;
+        std::shared_ptr<Expression const> m_argument;
 
     public:
-        [[nodiscard]] explicit Println(parser::Expression const& argument);
+        [[nodiscard]] explicit Println(parser::Expression const& argument, ExpressionPool& expressions);
 
-        [[nodiscard]] auto argument() const -> std::unique_ptr<Expression> const& {
+        [[nodiscard]] auto argument() const -> std::shared_ptr<Expression const> const& {
             return m_argument;
         }
     };
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utils/types.hpp>
+
+namespace type_checker {
+
+    // Interns the decoded contents of string literals, keyed by their lexemes. Every distinct literal is decoded
+    // once, and the returned views stay valid for the lifetime of the table (also after moving it), so runtime
+    // string values can refer to them without allocating. Every compilation owns its own table, see
+    // `TypeAnnotations`.
+    class StringTable final {
+    private:
+        struct LexemeHash final {
+            using is_transparent = void;
+
+            [[nodiscard]] auto operator()(std::string_view const lexeme) const -> usize {
+                return std::hash<std::string_view>{}(lexeme);
+            }
+        };
+
+        // The values of a node-based map never move, so views into them remain valid.
+        std::unordered_map<std::string, std::string, LexemeHash, std::equal_to<>> m_entries;
+
+    public:
+        [[nodiscard]] auto intern_literal(std::string_view lexeme) -> std::string_view;
+    };
+
+} // namespace type_checker
@@ -1,12 +1,39 @@
 #pragma once
 
+#include "annotations.hpp"
+#include "compilation_cache.hpp"
+#include "expression_pool.hpp"
 #include "statements.hpp"
+#include <expected>
 #include <memory>
 #include <parser/parser.hpp>
+#include <utils/diagnostics.hpp>
+#include <utils/thread_pool.hpp>
 #include <vector>
 #include "errors.hpp"
 
 namespace type_checker {
     [[nodiscard]] auto check_types(std::vector<std::unique_ptr<parser::Statement>> statements)
             -> std::vector<std::unique_ptr<Statement>>;
+
+    // Like `check_types()`, but interns the typed expressions into `expressions`. Statements that are checked with
+    // the same pool share nodes and ids, so they can be combined into one program.
+    [[nodiscard]] auto check_types(
+            std::vector<std::unique_ptr<parser::Statement>> statements,
+            ExpressionPool& expressions
+    ) -> std::vector<std::unique_ptr<Statement>>;
+
+    // Like `check_types()`, but reports errors to `diagnostics` instead of throwing. All invalid statements are
+    // reported, not only the first one.
+    [[nodiscard]] auto try_check_types(
+            std::vector<std::unique_ptr<parser::Statement>> statements,
+            utils::Diagnostics& diagnostics
+    ) -> std::expected<std::vector<std::unique_ptr<Statement>>, utils::DiagnosticKind>;
+
+    // Checks the top-level statements in parallel. The result, including which error is reported for an invalid
+    // program, is identical to the result of serial checking.
+    [[nodiscard]] auto check_types(
+            std::vector<std::unique_ptr<parser::Statement>> statements,
+            utils::WorkStealingPool& pool
+    ) -> std::vector<std::unique_ptr<Statement>>;
 } // namespace type_checker
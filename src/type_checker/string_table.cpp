@@ -0,0 +1,14 @@
+#include <type_checker/literals.hpp>
+#include <type_checker/string_table.hpp>
+
+namespace type_checker {
+
+    [[nodiscard]] auto StringTable::intern_literal(std::string_view const lexeme) -> std::string_view {
+        if (auto const it = m_entries.find(lexeme); it != m_entries.end()) {
+            return it->second;
+        }
+        auto const [it, _] = m_entries.emplace(std::string{ lexeme }, decode_string_literal(lexeme));
+        return it->second;
+    }
+
+} // namespace type_checker
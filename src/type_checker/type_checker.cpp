@@ -2,16 +2,111 @@
 #include <experimental/meta>
 #include <ranges>
 #include <algorithm>
+#include <exception>
+#include <expected>
 #include "checking.hpp"
 
 namespace type_checker {
 
     [[nodiscard]] auto check_types(std::vector<std::unique_ptr<parser::Statement>> statements)
             -> std::vector<std::unique_ptr<Statement>> {
+        auto expressions = ExpressionPool{};
+        return check_types(std::move(statements), expressions);
+    }
+
+    [[nodiscard]] auto check_types(
+            std::vector<std::unique_ptr<parser::Statement>> statements,
+            ExpressionPool& expressions
+    ) -> std::vector<std::unique_ptr<Statement>> {
+        auto program = std::vector<std::unique_ptr<Statement>>{};
+        program.reserve(statements.size());
+        for (auto const& statement : statements) {
+            program.push_back(
+                    check_child_types<parser::Statement, std::unique_ptr<Statement>>(*statement, expressions)
+            );
+        }
+        return program;
+    }
+
+    [[nodiscard]] auto try_check_types(
+            std::vector<std::unique_ptr<parser::Statement>> statements,
+            utils::Diagnostics& diagnostics
+    ) -> std::expected<std::vector<std::unique_ptr<Statement>>, utils::DiagnosticKind> {
+        auto expressions = ExpressionPool{};
         auto program = std::vector<std::unique_ptr<Statement>>{};
         program.reserve(statements.size());
+        auto const num_previous_diagnostics = diagnostics.size();
         for (auto const& statement : statements) {
-            program.push_back(check_child_types<parser::Statement, Statement>(*statement));
+            // The statements are independent of each other, so checking continues after a type error.
+            try {
+                program.push_back(
+                        check_child_types<parser::Statement, std::unique_ptr<Statement>>(*statement, expressions)
+                );
+            } catch (InvalidTypeError const& error) {
+                auto location = std::string{};
+                if (error.source_location().has_value()) {
+                    location = error.source_location()->format_position();
+                }
+                diagnostics.report(utils::DiagnosticKind::TypeError, error.what(), std::move(location));
+            } catch (std::exception const& error) {
+                // E.g. `std::bad_alloc` or `std::overflow_error` from the expression pool. These are not caused by
+                // the statement, so checking stops. Callers rely on `try_check_types()` not throwing.
+                diagnostics.report(utils::DiagnosticKind::TypeError, error.what());
+                return std::unexpected{ utils::DiagnosticKind::TypeError };
+            } catch (...) {
+                diagnostics.report(utils::DiagnosticKind::TypeError, "Unknown error.");
+                return std::unexpected{ utils::DiagnosticKind::TypeError };
+            }
+        }
+        if (diagnostics.size() != num_previous_diagnostics) {
+            return std::unexpected{ utils::DiagnosticKind::TypeError };
+        }
+        return program;
+    }
+
+    [[nodiscard]] auto check_types(
+            std::vector<std::unique_ptr<parser::Statement>> statements,
+            utils::WorkStealingPool& pool
+    ) -> std::vector<std::unique_ptr<Statement>> {
+        struct Diagnostic final {
+            usize statement_index;
+            std::exception_ptr error;
+        };
+
+        // Statements are distributed in chunks to keep the scheduling overhead low for large programs.
+        static constexpr auto chunk_size = 64uz;
+        auto const num_chunks = (statements.size() + chunk_size - 1) / chunk_size;
+
+        // All workers intern into the same pool, so that the result shares nodes just like after serial checking.
+        auto expressions = ExpressionPool{};
+        auto program = std::vector<std::unique_ptr<Statement>>(statements.size());
+        auto diagnostics_per_worker = std::vector<std::vector<Diagnostic>>(pool.num_workers());
+        pool.for_each_index(num_chunks, [&](usize const chunk_index, usize const worker_index) {
+            auto const begin = chunk_index * chunk_size;
+            auto const end = std::min(begin + chunk_size, statements.size());
+            for (auto i = begin; i < end; ++i) {
+                try {
+                    program.at(i) = check_child_types<parser::Statement, std::unique_ptr<Statement>>(
+                            *statements.at(i),
+                            expressions
+                    );
+                } catch (...) {
+                    diagnostics_per_worker.at(worker_index).push_back(Diagnostic{ i, std::current_exception() });
+                }
+            }
+        });
+
+        // Report the error that serial checking would have encountered first.
+        auto first_diagnostic = static_cast<Diagnostic const*>(nullptr);
+        for (auto const& diagnostics : diagnostics_per_worker) {
+            for (auto const& diagnostic : diagnostics) {
+                if (first_diagnostic == nullptr or diagnostic.statement_index < first_diagnostic->statement_index) {
+                    first_diagnostic = std::addressof(diagnostic);
+                }
+            }
+        }
+        if (first_diagnostic != nullptr) {
+            std::rethrow_exception(first_diagnostic->error);
         }
         return program;
     }
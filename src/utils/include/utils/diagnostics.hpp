@@ -0,0 +1,65 @@
+#pragma once
+
+#include "enum_to_string.hpp"
+#include "types.hpp"
+#include <cstdio>
+#include <print>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace utils {
+
+    // The pipeline stage that reported a diagnostic. The `try_*` functions of the stages return it as the error of
+    // their `std::expected` result, the details are collected in a `Diagnostics` buffer.
+    enum class DiagnosticKind {
+        LexerError,
+        ParserError,
+        TypeError,
+        RuntimeError,
+    };
+
+    struct Diagnostic final {
+        DiagnosticKind kind;
+        std::string message;
+        std::string location; // "filename:line:column", empty if unknown.
+    };
+
+    class Diagnostics final {
+    private:
+        std::vector<Diagnostic> m_diagnostics;
+
+    public:
+        auto report(DiagnosticKind const kind, std::string message, std::string location = {}) -> void {
+            m_diagnostics.push_back(Diagnostic{ kind, std::move(message), std::move(location) });
+        }
+
+        [[nodiscard]] auto entries() const -> std::span<Diagnostic const> {
+            return m_diagnostics;
+        }
+
+        [[nodiscard]] auto empty() const -> bool {
+            return m_diagnostics.empty();
+        }
+
+        [[nodiscard]] auto size() const -> usize {
+            return m_diagnostics.size();
+        }
+
+        auto clear() -> void {
+            m_diagnostics.clear();
+        }
+
+        auto print(FILE* const file) const -> void {
+            for (auto const& [kind, message, location] : m_diagnostics) {
+                if (location.empty()) {
+                    std::println(file, "{}: {}", enum_to_string(kind), message);
+                } else {
+                    std::println(file, "{}: {}: {}", location, enum_to_string(kind), message);
+                }
+            }
+        }
+    };
+
+} // namespace utils
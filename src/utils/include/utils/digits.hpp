@@ -0,0 +1,102 @@
+#pragma once
+
+#include "types.hpp"
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <expected>
+#include <limits>
+#include <string_view>
+
+namespace utils {
+
+    enum class DecimalParseError {
+        InvalidDigit,
+        OutOfRange,
+    };
+
+    namespace detail {
+        // Checks eight ASCII characters at once (SWAR): every byte must be in the range '0' to '9'.
+        [[nodiscard]] constexpr auto are_eight_digits(std::uint64_t const chunk) -> bool {
+            return ((chunk & 0xF0F0'F0F0'F0F0'F0F0) | (((chunk + 0x0606'0606'0606'0606) & 0xF0F0'F0F0'F0F0'F0F0) >> 4))
+                   == 0x3333'3333'3333'3333;
+        }
+
+        // Converts eight ASCII digits, the most significant one in the lowest byte, by combining adjacent digits
+        // into pairs, then quadruples and finally the whole number. Three multiplications instead of eight.
+        [[nodiscard]] constexpr auto parse_eight_digits(std::uint64_t chunk) -> std::uint64_t {
+            chunk = ((chunk & 0x0F0F'0F0F'0F0F'0F0F) * 2561) >> 8;
+            chunk = ((chunk & 0x00FF'00FF'00FF'00FF) * 6553601) >> 16;
+            return ((chunk & 0x0000'FFFF'0000'FFFF) * 42949672960001) >> 32;
+        }
+
+        [[nodiscard]] constexpr auto load_chunk(std::array<char, 24> const& digits, usize const offset)
+                -> std::uint64_t {
+            auto bytes = std::array<char, 8>{};
+            for (auto i = 0uz; i < bytes.size(); ++i) {
+                bytes[i] = digits[offset + i];
+            }
+            auto const chunk = std::bit_cast<std::uint64_t>(bytes);
+            if constexpr (std::endian::native == std::endian::big) {
+                return std::byteswap(chunk);
+            } else {
+                return chunk;
+            }
+        }
+    } // namespace detail
+
+    // Parses a decimal number whose digits may be interspersed with `separator` characters. The significant digits
+    // are right-aligned in a buffer of 24 zeros and converted eight at a time.
+    [[nodiscard]] constexpr auto parse_decimal(std::string_view const text, char const separator)
+            -> std::expected<std::uint64_t, DecimalParseError> {
+        // 2^64 - 1 has 20 decimal digits.
+        static constexpr auto max_num_digits = 20uz;
+
+        auto significant_digits = std::array<char, max_num_digits>{};
+        auto num_digits = 0uz;
+        auto has_digits = false;
+        for (auto const c : text) {
+            if (c == separator) {
+                continue;
+            }
+            has_digits = true;
+            if (c == '0' and num_digits == 0) {
+                continue; // Leading zeros don't count towards the limit.
+            }
+            if (num_digits == max_num_digits) {
+                return std::unexpected{ DecimalParseError::OutOfRange };
+            }
+            significant_digits[num_digits++] = c;
+        }
+        if (not has_digits) {
+            return std::unexpected{ DecimalParseError::InvalidDigit };
+        }
+
+        auto digits = std::array<char, 24>{};
+        digits.fill('0');
+        for (auto i = 0uz; i < num_digits; ++i) {
+            digits[digits.size() - num_digits + i] = significant_digits[i];
+        }
+
+        auto const high_chunk = detail::load_chunk(digits, 0);
+        auto const middle_chunk = detail::load_chunk(digits, 8);
+        auto const low_chunk = detail::load_chunk(digits, 16);
+        if (not detail::are_eight_digits(high_chunk) or not detail::are_eight_digits(middle_chunk)
+            or not detail::are_eight_digits(low_chunk)) {
+            return std::unexpected{ DecimalParseError::InvalidDigit };
+        }
+
+        static constexpr auto max_high_part = std::numeric_limits<std::uint64_t>::max() / 10'000'000'000'000'000;
+        auto const high_part = detail::parse_eight_digits(high_chunk);
+        if (high_part > max_high_part) {
+            return std::unexpected{ DecimalParseError::OutOfRange };
+        }
+        auto const upper = high_part * 10'000'000'000'000'000;
+        auto const lower = detail::parse_eight_digits(middle_chunk) * 100'000'000 + detail::parse_eight_digits(low_chunk);
+        if (upper > std::numeric_limits<std::uint64_t>::max() - lower) {
+            return std::unexpected{ DecimalParseError::OutOfRange };
+        }
+        return upper + lower;
+    }
+
+} // namespace utils
@@ -2,8 +2,10 @@
 
 #include <filesystem>
 #include <fstream>
+#include <iostream>
 #include <optional>
 #include <sstream>
+#include <string>
 
 namespace utils {
 
@@ -17,4 +19,10 @@ namespace utils {
         return std::move(stream).str();
     }
 
+    [[nodiscard]] inline auto read_stdin() -> std::string {
+        auto stream = std::ostringstream{};
+        stream << std::cin.rdbuf();
+        return std::move(stream).str();
+    }
+
 }
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <concepts>
+#include <cstdio>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <ranges>
 #include <experimental/meta>
@@ -119,6 +121,7 @@ template<typename Derived>
 
 template<typename T>
 auto pretty_print(
+    FILE* const file,
     T&& object,
     usize const indentation = 0uz,
     bool const print_ending_newline = true
@@ -126,32 +129,34 @@ auto pretty_print(
     using Type = std::decay_t<T>;
 
     if constexpr (std::integral<Type> or std::floating_point<Type> or std::same_as<Type, bool>) {
-        std::print("{}", object);
-    } else if constexpr (std::same_as<Type, std::string> or std::same_as<Type, char const*>) {
-        std::print("\"{}\"", object);
+        std::print(file, "{}", object);
+    } else if constexpr (
+        std::same_as<Type, std::string> or std::same_as<Type, std::string_view> or std::same_as<Type, char const*>
+    ) {
+        std::print(file, "\"{}\"", object);
     } else if constexpr (std::is_enum_v<Type>) {
-        std::print("{}::{}", identifier_of(dealias(^^Type)), utils::enum_to_string(object));
+        std::print(file, "{}::{}", identifier_of(dealias(^^Type)), utils::enum_to_string(object));
     } else if constexpr (requires { { object.has_value() }; { object.value() }; }) {
         if (object.has_value()) {
-            pretty_print(object.value(), indentation, false);
+            pretty_print(file, object.value(), indentation, false);
         } else {
-            std::print("null");
+            std::print(file, "null");
         }
     } else if constexpr (requires { { *object }; }) {
         if (object == nullptr) {
-            std::print("null");
+            std::print(file, "null");
             return;
         }
-        std::print("&");
-        pretty_print(*object, indentation, false);
+        std::print(file, "&");
+        pretty_print(file, *object, indentation, false);
     } else if constexpr (std::ranges::range<Type>) {
-        std::println("[");
+        std::println(file, "[");
         for (auto const& element : object) {
-            std::print("{:{}}", "", indentation + 2uz);
-            pretty_print(element, indentation + 2uz, false);
-            std::println(",");
+            std::print(file, "{:{}}", "", indentation + 2uz);
+            pretty_print(file, element, indentation + 2uz, false);
+            std::println(file, ",");
         }
-        std::print("{:{}}]", "", indentation);
+        std::print(file, "{:{}}]", "", indentation);
     } else if constexpr (is_class_type(dealias(^^Type)) and parent_of(^^Type) != ^^std) {
         using Parent = [: get_parent<Type>() :];
         [[maybe_unused]] Parent* _;
@@ -178,18 +183,18 @@ auto pretty_print(
                 auto is_first = true;
                 template for (constexpr auto type_in_chain : chain) {
                     if (not is_first) {
-                        std::print("<-");
+                        std::print(file, "<-");
                     }
-                    std::print("{}", identifier_of(type_in_chain));
+                    std::print(file, "{}", identifier_of(type_in_chain));
                     is_first = false;
                 }
-                std::println("{{");
+                std::println(file, "{{");
                 template for (constexpr auto type_in_chain : chain) {
                     static constexpr auto context = std::meta::access_context::current();
                     template for (constexpr auto member : std::define_static_array(nonstatic_data_members_of(dealias(type_in_chain), context))) {
-                        std::print("{:{}}{}: ", "", indentation + 2uz, identifier_of(member));
-                        pretty_print(object.[: member :], indentation + 2uz, false);
-                        std::println(",");
+                        std::print(file, "{:{}}{}: ", "", indentation + 2uz, identifier_of(member));
+                        pretty_print(file, object.[: member :], indentation + 2uz, false);
+                        std::println(file, ",");
                     }
                     auto const downcasted = dynamic_cast<[: type_in_chain :] const*>(std::addressof(object));
                     if (downcasted == nullptr) {
@@ -204,19 +209,24 @@ auto pretty_print(
                             and not is_pure_virtual(member)
                             and requires { { object.[: member :]() }; }
                         ) {
-                            std::print("{:{}}{}(): ", "", indentation + 2uz, identifier_of(member));
+                            std::print(file, "{:{}}{}(): ", "", indentation + 2uz, identifier_of(member));
                             auto&& value = object.[: member :]();
-                            pretty_print(std::forward<decltype(value)>(value), indentation + 2uz, false);
-                            std::println(",");
+                            pretty_print(file, std::forward<decltype(value)>(value), indentation + 2uz, false);
+                            std::println(file, ",");
                         }
                     }
                 }
-                std::print("{:{}}}}", "", indentation);
+                std::print(file, "{:{}}}}", "", indentation);
             }
             ++type_index;
         }
     }
     if (print_ending_newline) {
-        std::println();
+        std::println(file);
     }
 }
+
+template<typename T>
+auto pretty_print(T&& object, usize const indentation = 0uz, bool const print_ending_newline = true) -> void {
+    pretty_print(stdout, std::forward<T>(object), indentation, print_ending_newline);
+}
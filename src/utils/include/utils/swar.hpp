@@ -0,0 +1,46 @@
+#pragma once
+
+#include "types.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace utils {
+
+    // Returns the index of the first occurrence of `byte` in `text`, or `text.length()` if there is none. Scans
+    // eight bytes at a time (SWAR) outside of constant evaluation.
+    [[nodiscard]] constexpr auto find_byte(std::string_view const text, char const byte) -> usize {
+        if consteval {
+            return std::min(text.find(byte), text.length());
+        }
+
+        static constexpr auto ones = std::uint64_t{ 0x0101'0101'0101'0101 };
+        static constexpr auto high_bits = std::uint64_t{ 0x8080'8080'8080'8080 };
+        auto const pattern = ones * static_cast<unsigned char>(byte);
+
+        auto offset = 0uz;
+        for (; offset + sizeof(std::uint64_t) <= text.length(); offset += sizeof(std::uint64_t)) {
+            auto chunk = std::uint64_t{};
+            std::memcpy(&chunk, text.data() + offset, sizeof(chunk));
+            if constexpr (std::endian::native == std::endian::big) {
+                chunk = std::byteswap(chunk);
+            }
+            // Bytes that equal `byte` become zero. The lowest set bit of `found` marks the first zero byte, higher
+            // bits may be false positives.
+            auto const difference = chunk ^ pattern;
+            auto const found = (difference - ones) & ~difference & high_bits;
+            if (found != 0) {
+                return offset + static_cast<usize>(std::countr_zero(found)) / 8;
+            }
+        }
+        for (; offset < text.length(); ++offset) {
+            if (text[offset] == byte) {
+                return offset;
+            }
+        }
+        return text.length();
+    }
+
+} // namespace utils
@@ -0,0 +1,168 @@
+#pragma once
+
+#include "types.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace utils {
+
+    // Fixed-size pool of worker threads. Every worker owns a queue of task indices and takes work from its front.
+    // Workers whose queue ran dry steal from the back of the other workers' queues.
+    class WorkStealingPool final {
+    private:
+        struct Queue final {
+            std::mutex mutex;
+            std::deque<usize> indices;
+        };
+
+        std::vector<std::unique_ptr<Queue>> m_queues;
+        std::vector<std::jthread> m_threads;
+
+        std::mutex m_submit_mutex;
+        std::mutex m_mutex;
+        std::condition_variable m_start_condition;
+        std::condition_variable m_done_condition;
+        std::function<void(usize, usize)> const* m_function{ nullptr };
+        usize m_generation{ 0 };
+        usize m_num_busy_threads{ 0 };
+        bool m_is_stopping{ false };
+        std::exception_ptr m_exception;
+
+    public:
+        [[nodiscard]] explicit WorkStealingPool(
+                usize const num_workers = std::max(usize{ std::thread::hardware_concurrency() }, 1uz)
+        ) {
+            // A count of zero is treated as one, since the thread that calls `for_each_index()` is always worker 0.
+            auto const num_queues = std::max(num_workers, 1uz);
+            m_queues.reserve(num_queues);
+            for (auto i = 0uz; i < num_queues; ++i) {
+                m_queues.push_back(std::make_unique<Queue>());
+            }
+            // Worker 0 needs no thread of its own, so we only need to spawn the others.
+            m_threads.reserve(num_queues - 1);
+            for (auto i = 1uz; i < num_queues; ++i) {
+                m_threads.emplace_back([this, i] { worker_loop(i); });
+            }
+        }
+
+        WorkStealingPool(WorkStealingPool const& other) = delete;
+        WorkStealingPool(WorkStealingPool&& other) noexcept = delete;
+        WorkStealingPool& operator=(WorkStealingPool const& other) = delete;
+        WorkStealingPool& operator=(WorkStealingPool&& other) noexcept = delete;
+
+        ~WorkStealingPool() {
+            {
+                auto const lock = std::scoped_lock{ m_mutex };
+                m_is_stopping = true;
+            }
+            m_start_condition.notify_all();
+            m_threads.clear();
+        }
+
+        [[nodiscard]] auto num_workers() const -> usize {
+            return m_queues.size();
+        }
+
+        // Invokes `function(index, worker_index)` for every index in `[0, count)` and blocks until all invocations
+        // have returned. Calls of the same worker never overlap. If any invocation throws, the first exception that
+        // has been caught is rethrown after all other invocations have finished.
+        auto for_each_index(usize const count, std::function<void(usize, usize)> const& function) -> void {
+            auto const submit_lock = std::scoped_lock{ m_submit_mutex };
+
+            // Every worker starts with a contiguous range of indices.
+            for (auto i = 0uz; i < count; ++i) {
+                auto& queue = *m_queues.at(i * num_workers() / count);
+                auto const lock = std::scoped_lock{ queue.mutex };
+                queue.indices.push_back(i);
+            }
+
+            {
+                auto const lock = std::scoped_lock{ m_mutex };
+                m_function = std::addressof(function);
+                m_num_busy_threads = m_threads.size();
+                m_exception = nullptr;
+                ++m_generation;
+            }
+            m_start_condition.notify_all();
+
+            work(0uz);
+
+            auto lock = std::unique_lock{ m_mutex };
+            m_done_condition.wait(lock, [this] { return m_num_busy_threads == 0; });
+            m_function = nullptr;
+            if (m_exception != nullptr) {
+                std::rethrow_exception(std::exchange(m_exception, nullptr));
+            }
+        }
+
+    private:
+        auto worker_loop(usize const worker_index) -> void {
+            auto last_generation = 0uz;
+            while (true) {
+                {
+                    auto lock = std::unique_lock{ m_mutex };
+                    m_start_condition.wait(lock, [&] {
+                        return m_is_stopping or m_generation != last_generation;
+                    });
+                    if (m_is_stopping) {
+                        return;
+                    }
+                    last_generation = m_generation;
+                }
+
+                work(worker_index);
+
+                auto const lock = std::scoped_lock{ m_mutex };
+                --m_num_busy_threads;
+                if (m_num_busy_threads == 0) {
+                    m_done_condition.notify_all();
+                }
+            }
+        }
+
+        auto work(usize const worker_index) -> void {
+            while (auto const index = next_index(worker_index)) {
+                try {
+                    (*m_function)(index.value(), worker_index);
+                } catch (...) {
+                    auto const lock = std::scoped_lock{ m_mutex };
+                    if (m_exception == nullptr) {
+                        m_exception = std::current_exception();
+                    }
+                }
+            }
+        }
+
+        [[nodiscard]] auto next_index(usize const worker_index) -> std::optional<usize> {
+            {
+                auto& own_queue = *m_queues.at(worker_index);
+                auto const lock = std::scoped_lock{ own_queue.mutex };
+                if (not own_queue.indices.empty()) {
+                    auto const index = own_queue.indices.front();
+                    own_queue.indices.pop_front();
+                    return index;
+                }
+            }
+            for (auto offset = 1uz; offset < num_workers(); ++offset) {
+                auto& victim = *m_queues.at((worker_index + offset) % num_workers());
+                auto const lock = std::scoped_lock{ victim.mutex };
+                if (not victim.indices.empty()) {
+                    auto const index = victim.indices.back();
+                    victim.indices.pop_back();
+                    return index;
+                }
+            }
+            return std::nullopt;
+        }
+    };
+
+} // namespace utils